@@ -35,15 +35,21 @@
     ADSTLOG_CORE_CH_NAME,      \
     ADSTLOG_ACTOR_CH_NAME
 
-// the actual call for the trace function
-#define ADSTLOG_LOG_ON(OBJ, LVL, CHANNEL, MODULE, ...) \
-    OBJ->CHANNEL->getObj()->Trace(0,                   \
-                   LVL,                                \
-                   OBJ->MODULE,                        \
-                   (tUINT16)__LINE__,                  \
-                   (const char*)__FILE__,              \
-                   (const char*)__FUNCTION__,          \
-                   __VA_ARGS__)
+// the actual call for the trace function, the arguments are only evaluated when the verbosity of
+// the module lets the level pass
+#define ADSTLOG_LOG_ON(OBJ, LVL, CHANNEL, MODULE, ...)                       \
+    do {                                                                     \
+        IP7_Trace* adstlogTrace = OBJ->CHANNEL->getObj();                    \
+        if (adstlogTrace->Get_Verbosity(OBJ->MODULE) <= LVL) {               \
+            adstlogTrace->Trace(0,                                           \
+                           LVL,                                              \
+                           OBJ->MODULE,                                      \
+                           (tUINT16)__LINE__,                                \
+                           (const char*)__FILE__,                            \
+                           (const char*)__FUNCTION__,                        \
+                           __VA_ARGS__);                                     \
+        }                                                                    \
+    } while (false)
 
 // then the logging is happening in a class where trace defined
 #define ADSTLOG_LOG(...)   \
@@ -138,7 +144,12 @@
 #define LOG_C_E(...) LOG_CH_E(CORE, __VA_ARGS__)
 #define LOG_C_W(...) LOG_CH_W(CORE, __VA_ARGS__)
 #define LOG_C_I(...) LOG_CH_I(CORE, __VA_ARGS__)
-#define LOG_C_D(...) LOG_CH_D(CORE, __VA_ARGS__)
+// core DEBUG_LEVEL is on the hot path of every message, release builds may strip it.
+#ifdef ADSTLOG_DEBUG_LEVEL_CORE_COMPILED_IN
+    #define LOG_C_D(...) LOG_CH_D(CORE, __VA_ARGS__)
+#else
+    #define LOG_C_D(...)
+#endif
 // core trace TRACE_LEVEL very verbose and has performance penalty it is not compiled in by default.
 #ifdef ADSTLOG_TRACE_LEVEL_CORE_COMPILED_IN
     #define LOG_C_T(...) LOG_CH_T(CORE, __VA_ARGS__)
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+namespace adst::common {
+
+// dense counterpart of type_id_t: small consecutive numbers which can be used as vector index.
+using type_index_t = std::uint32_t;
+
+namespace detail {
+
+/**
+ * Hands out the next free type index. The counter lives in a single translation unit so the indices
+ * are unique within the process.
+ * @return A type index never returned before.
+ */
+type_index_t nextTypeIndex();
+
+} // namespace detail
+
+// the index is assigned on first use (thread safe), so the numbers depend on the order in which the
+// types are first used, but a given type always gets the same number within the process.
+// it is a function local static of an inline function, the same linkage caveat as for type_id()
+// applies for dynamic libraries.
+template <typename T>
+type_index_t type_index()
+{
+    static const type_index_t index = detail::nextTypeIndex();
+    return index;
+}
+
+} // namespace adst::common
@@ -0,0 +1,13 @@
+#include "adstutil_cxx/type_index.hpp"
+
+#include <atomic>
+
+namespace adst::common::detail {
+
+type_index_t nextTypeIndex()
+{
+    static std::atomic<type_index_t> counter = {0};
+    return counter.fetch_add(1);
+}
+
+} // namespace adst::common::detail
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+
 #include "adstutil_cxx/error_handler.hpp"
 #include "config_cxx/yaml_wrapper.hpp"
 
@@ -17,10 +19,11 @@ namespace adst::common {
  */
 struct Config
 {
-    static constexpr int  DEFAULT_NUMBER_OF_DISPATCHERS = 4; /// default number of dispatchers.
-    static constexpr auto LOGGER_NAME                   = sstr::literal("TEST_ENGINE");
-    static constexpr auto CONFIG_FILE_NAME              = sstr::literal("config.yml");
-    static constexpr auto DEFAULT_CONFIG                = sstr::literal(
+    static constexpr int  DEFAULT_NUMBER_OF_DISPATCHERS       = 4;  /// default number of dispatchers.
+    static constexpr int  DEFAULT_MAX_MESSAGES_PER_ACTIVATION = 64; /// default message budget of an actor activation
+    static constexpr auto LOGGER_NAME                         = sstr::literal("TEST_ENGINE");
+    static constexpr auto CONFIG_FILE_NAME                    = sstr::literal("config.yml");
+    static constexpr auto DEFAULT_CONFIG                      = sstr::literal(
         "---\n"
         "logging:\n"
         "  client:\n"
@@ -34,6 +37,14 @@ struct Config
     const int   numberOfDispatchers_ = DEFAULT_NUMBER_OF_DISPATCHERS; /// number of dispatchers created in a priority
     std::string defConfFileName_     = {CONFIG_FILE_NAME};
     std::string defConfFileContent_  = {DEFAULT_CONFIG};
+    /// messages an actor dispatches before it gives the dispatcher to the next actor, 0 means no limit
+    int maxMessagesPerActivation_ = DEFAULT_MAX_MESSAGES_PER_ACTIVATION;
+    /// time an actor may keep a dispatcher before it gives it to the next actor, 0 means no limit
+    std::chrono::microseconds maxActivationTime_ = std::chrono::microseconds{0};
+    /// dispatchers of the high priority level, 0 means high priority actors share the normal dispatchers
+    int highPriorityDispatchers_ = 0;
+    /// dispatchers of the low priority level, 0 means low priority actors share the normal dispatchers
+    int lowPriorityDispatchers_ = 0;
     /// config key value pairs make sure that it is the last member so list initialises can omit it.
     YamlWrapper configDoc_ = YamlWrapper(onErrorCallBack_, defConfFileContent_, defConfFileName_);
 };
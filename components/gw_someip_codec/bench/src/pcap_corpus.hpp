@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gw_someip_codec/byte_order.hpp"
+#include "gw_someip_codec/payload_codec.hpp"
+#include "gw_someip_codec/someip_codec.hpp"
+#include "gw_someip_codec/span.hpp"
+
+/**
+ * @file pcap_corpus.hpp SOME/IP traffic in the classic pcap file format for the codec benchmarks.
+ *
+ * A recording (Ethernet, IPv4, UDP) can be given in the SOMEIP_PCAP environment variable, otherwise an
+ * equivalent capture is synthesized in memory, so the benchmarks run the same code path either way.
+ */
+
+namespace adst::ep::gw::someip::bench {
+
+constexpr std::uint32_t PCAP_MAGIC       = 0xa1b2c3d4; /// microsecond time stamps, file byte order tells itself
+constexpr std::size_t   PCAP_FILE_HEADER = 24;
+constexpr std::size_t   PCAP_RECORD      = 16; /// time stamp, captured and original length
+constexpr std::uint32_t LINKTYPE_ETHER   = 1;
+constexpr std::size_t   ETHER_HEADER     = 14;
+constexpr std::uint16_t ETHERTYPE_IPV4   = 0x0800;
+constexpr std::size_t   IPV4_HEADER      = 20; /// without options, longer headers are read from the IHL
+constexpr std::uint8_t  IP_PROTOCOL_UDP  = 17;
+constexpr std::size_t   UDP_HEADER       = 8;
+
+/**
+ * Payload of the synthesized messages, a typical sensor sample with a dynamic length blob.
+ */
+struct Sample
+{
+    std::uint32_t objectId_  = 0;
+    std::uint64_t timestamp_ = 0;
+    float         quality_   = 0;
+    ConstByteSpan data_;
+
+    static constexpr auto FIELDS =
+        std::make_tuple(&Sample::objectId_, &Sample::timestamp_, &Sample::quality_, &Sample::data_);
+};
+
+namespace impl {
+
+/**
+ * The pcap headers are in the byte order of the machine which wrote the file.
+ */
+inline std::uint32_t loadPcap32(const std::uint8_t* bytes, bool littleEndian)
+{
+    if (!littleEndian) {
+        return loadBigEndian<std::uint32_t>(bytes);
+    }
+    return static_cast<std::uint32_t>(bytes[0]) | static_cast<std::uint32_t>(bytes[1]) << 8U
+           | static_cast<std::uint32_t>(bytes[2]) << 16U | static_cast<std::uint32_t>(bytes[3]) << 24U;
+}
+
+inline void appendLittle32(std::vector<std::uint8_t>& out, std::uint32_t value)
+{
+    for (int byte = 0; byte < 4; ++byte) {
+        out.push_back(static_cast<std::uint8_t>(value >> (8U * static_cast<unsigned>(byte))));
+    }
+}
+
+} // namespace impl
+
+/**
+ * Synthesizes a little endian capture as tcpdump writes it on x86. Each UDP datagram carries one to
+ * three notifications; the payloads are Sample structs with 0 to 1 KiB of data, mostly small ones.
+ * @param datagrams Number of captured frames.
+ * @return The pcap file content.
+ */
+inline std::vector<std::uint8_t> synthesizePcap(int datagrams)
+{
+    std::vector<std::uint8_t> pcap;
+    impl::appendLittle32(pcap, PCAP_MAGIC);
+    impl::appendLittle32(pcap, 0x00040002); // version 2.4
+    impl::appendLittle32(pcap, 0);          // time zone
+    impl::appendLittle32(pcap, 0);          // time stamp accuracy
+    impl::appendLittle32(pcap, 0xffff);     // snap length
+    impl::appendLittle32(pcap, LINKTYPE_ETHER);
+
+    std::minstd_rand                random(42); // NOLINT(cert-msc32-c,cert-msc51-cpp) same corpus on each run
+    const std::vector<std::size_t>  dataSizes = {0, 16, 16, 64, 64, 64, 256, 1024};
+    const std::vector<std::uint8_t> blob(1024, 0x5a);
+    std::vector<std::uint8_t>       datagram;
+    std::uint16_t                   session = 0;
+    for (int frame = 0; frame < datagrams; ++frame) {
+        datagram.clear();
+        const auto messages = 1 + random() % 3;
+        for (unsigned message = 0; message < messages; ++message) {
+            Sample sample;
+            sample.objectId_  = static_cast<std::uint32_t>(random());
+            sample.timestamp_ = static_cast<std::uint64_t>(frame) * 1000;
+            sample.quality_   = 0.5F;
+            sample.data_      = {blob.data(), dataSizes[random() % dataSizes.size()]};
+            const auto   method = static_cast<std::uint16_t>(0x8001 + random() % 4);
+            const Header header = {0x0100, method, 0, ++session, PROTOCOL_VERSION, 1, MessageType::NOTIFICATION};
+            const auto   offset = datagram.size();
+            datagram.resize(offset + HEADER_SIZE + serializedSize(sample));
+            buildMessage(ByteSpan{datagram.data() + offset, datagram.size() - offset}, header, sample);
+        }
+
+        const auto frameSize = ETHER_HEADER + IPV4_HEADER + UDP_HEADER + datagram.size();
+        impl::appendLittle32(pcap, static_cast<std::uint32_t>(frame / 1000));
+        impl::appendLittle32(pcap, static_cast<std::uint32_t>(frame % 1000) * 1000);
+        impl::appendLittle32(pcap, static_cast<std::uint32_t>(frameSize));
+        impl::appendLittle32(pcap, static_cast<std::uint32_t>(frameSize));
+
+        const auto start = pcap.size();
+        pcap.resize(start + ETHER_HEADER + IPV4_HEADER + UDP_HEADER);
+        auto* headers = pcap.data() + start;
+        storeBigEndian(ETHERTYPE_IPV4, headers + 12);
+        headers += ETHER_HEADER;
+        headers[0] = 0x45; // version 4, 5 words
+        storeBigEndian(static_cast<std::uint16_t>(IPV4_HEADER + UDP_HEADER + datagram.size()), headers + 2);
+        headers[8] = 64; // TTL
+        headers[9] = IP_PROTOCOL_UDP;
+        headers += IPV4_HEADER;
+        storeBigEndian(std::uint16_t{30490}, headers);
+        storeBigEndian(std::uint16_t{30490}, headers + 2);
+        storeBigEndian(static_cast<std::uint16_t>(UDP_HEADER + datagram.size()), headers + 4);
+        pcap.insert(pcap.end(), datagram.begin(), datagram.end());
+    }
+    return pcap;
+}
+
+/**
+ * @param path A pcap file.
+ * @return Its content, empty if it can not be read.
+ */
+inline std::vector<std::uint8_t> readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+/**
+ * Finds the UDP payloads of a capture. Frames which are not Ethernet, IPv4 and UDP are skipped, so
+ * are fragments and truncated frames.
+ * @param pcap The pcap file content, shall outlive the result.
+ * @return Views of the UDP payloads into the capture.
+ */
+inline std::vector<ConstByteSpan> udpPayloads(const std::vector<std::uint8_t>& pcap)
+{
+    std::vector<ConstByteSpan> payloads;
+    if (pcap.size() < PCAP_FILE_HEADER) {
+        return payloads;
+    }
+    const bool littleEndian = impl::loadPcap32(pcap.data(), false) != PCAP_MAGIC;
+    if (impl::loadPcap32(pcap.data(), littleEndian) != PCAP_MAGIC
+        || impl::loadPcap32(pcap.data() + 20, littleEndian) != LINKTYPE_ETHER) {
+        return payloads;
+    }
+    for (std::size_t offset = PCAP_FILE_HEADER; offset + PCAP_RECORD <= pcap.size();) {
+        const auto captured = impl::loadPcap32(pcap.data() + offset + 8, littleEndian);
+        const auto original = impl::loadPcap32(pcap.data() + offset + 12, littleEndian);
+        offset += PCAP_RECORD;
+        if (captured > pcap.size() - offset) {
+            break;
+        }
+        const ConstByteSpan frame = {pcap.data() + offset, captured};
+        offset += captured;
+        if (captured != original || frame.size() < ETHER_HEADER + IPV4_HEADER
+            || loadBigEndian<std::uint16_t>(frame.data() + 12) != ETHERTYPE_IPV4) {
+            continue;
+        }
+        const auto ip       = frame.subspan(ETHER_HEADER);
+        const auto ipHeader = static_cast<std::size_t>(ip[0] & 0x0fU) * 4;
+        const bool fragment = (loadBigEndian<std::uint16_t>(ip.data() + 6) & 0x3fffU) != 0;
+        if (ip[9] != IP_PROTOCOL_UDP || fragment || ip.size() < ipHeader + UDP_HEADER) {
+            continue;
+        }
+        const auto udp    = ip.subspan(ipHeader);
+        const auto length = loadBigEndian<std::uint16_t>(udp.data() + 4);
+        if (length < UDP_HEADER || length > udp.size()) {
+            continue;
+        }
+        payloads.push_back(udp.subspan(UDP_HEADER, length - UDP_HEADER));
+    }
+    return payloads;
+}
+
+} // namespace adst::ep::gw::someip::bench
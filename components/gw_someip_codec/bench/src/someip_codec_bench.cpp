@@ -0,0 +1,123 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "gw_someip_codec/payload_codec.hpp"
+#include "gw_someip_codec/someip_codec.hpp"
+#include "pcap_corpus.hpp"
+
+using adst::ep::gw::someip::buildMessage;
+using adst::ep::gw::someip::ByteSpan;
+using adst::ep::gw::someip::ConstByteSpan;
+using adst::ep::gw::someip::deserialize;
+using adst::ep::gw::someip::Header;
+using adst::ep::gw::someip::HEADER_SIZE;
+using adst::ep::gw::someip::MessageReader;
+using adst::ep::gw::someip::MessageView;
+using adst::ep::gw::someip::serializedSize;
+using adst::ep::gw::someip::bench::readFile;
+using adst::ep::gw::someip::bench::Sample;
+using adst::ep::gw::someip::bench::synthesizePcap;
+using adst::ep::gw::someip::bench::udpPayloads;
+
+namespace {
+
+constexpr int CORPUS_DATAGRAMS = 10000; /// frames of the synthesized capture
+
+/**
+ * The capture given in SOMEIP_PCAP or the synthesized one, loaded once for all benchmarks.
+ */
+const std::vector<ConstByteSpan>& getDatagrams()
+{
+    static const std::vector<std::uint8_t> pcap = [] {
+        const char* path = std::getenv("SOMEIP_PCAP"); // NOLINT(concurrency-mt-unsafe) read before any thread
+        return path != nullptr ? readFile(path) : synthesizePcap(CORPUS_DATAGRAMS);
+    }();
+    static const std::vector<ConstByteSpan> datagrams = udpPayloads(pcap);
+    if (datagrams.empty()) {
+        std::cerr << "no UDP datagrams in the capture" << std::endl;
+        exit(1);
+    }
+    return datagrams;
+}
+
+/**
+ * Header parsing only: walks all messages of all datagrams and touches the routing fields.
+ */
+void BM_SomeIpParse(benchmark::State& state)
+{
+    const auto&  datagrams = getDatagrams();
+    std::int64_t messages  = 0;
+    std::int64_t bytes     = 0;
+    for (auto _ : state) {
+        for (const auto& datagram : datagrams) {
+            MessageReader reader(datagram);
+            MessageView   message;
+            while (reader.next(message)) {
+                benchmark::DoNotOptimize(message.messageId());
+                benchmark::DoNotOptimize(message.payload().data());
+                ++messages;
+            }
+            bytes += static_cast<std::int64_t>(datagram.size());
+        }
+    }
+    state.SetItemsProcessed(messages);
+    state.SetBytesProcessed(bytes);
+}
+
+/**
+ * Parsing plus payload decoding into Sample structs; the data blob stays a view into the capture.
+ * Messages of a recording which are not Samples mostly fail to decode, they are counted anyway.
+ */
+void BM_SomeIpParseAndDecode(benchmark::State& state)
+{
+    const auto&  datagrams = getDatagrams();
+    std::int64_t messages  = 0;
+    std::int64_t bytes     = 0;
+    Sample       sample;
+    for (auto _ : state) {
+        for (const auto& datagram : datagrams) {
+            MessageReader reader(datagram);
+            MessageView   message;
+            while (reader.next(message)) {
+                benchmark::DoNotOptimize(deserialize(message.payload(), sample));
+                benchmark::DoNotOptimize(sample);
+                ++messages;
+            }
+            bytes += static_cast<std::int64_t>(datagram.size());
+        }
+    }
+    state.SetItemsProcessed(messages);
+    state.SetBytesProcessed(bytes);
+}
+
+/**
+ * Builds notifications in place into a send buffer. Argument is the size of the data blob.
+ */
+void BM_SomeIpBuild(benchmark::State& state)
+{
+    const std::vector<std::uint8_t> blob(static_cast<std::size_t>(state.range(0)), 0x5a);
+    Sample                          sample;
+    sample.data_ = {blob.data(), blob.size()};
+    std::vector<std::uint8_t> buffer(HEADER_SIZE + serializedSize(sample));
+    Header                    header = {0x0100, 0x8001};
+    for (auto _ : state) {
+        ++header.sessionId_;
+        ++sample.objectId_;
+        benchmark::DoNotOptimize(buildMessage(ByteSpan{buffer.data(), buffer.size()}, header, sample));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * buffer.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_SomeIpParse);
+BENCHMARK(BM_SomeIpParseAndDecode);
+BENCHMARK(BM_SomeIpBuild)->Arg(0)->Arg(64)->Arg(1024);
+
+BENCHMARK_MAIN();
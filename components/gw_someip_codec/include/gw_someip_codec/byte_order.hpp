@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace adst::ep::gw::someip {
+
+/**
+ * SOME/IP puts everything on the wire in network byte order. Reads and writes go through these
+ * instead of casting the buffer, the buffer needs no alignment and the compiler turns the shifts
+ * into a single load and byte swap.
+ *
+ * @tparam T Unsigned integer type.
+ * @param bytes At least sizeof(T) bytes.
+ * @return The big endian value at bytes.
+ */
+template <typename T>
+constexpr T loadBigEndian(const std::uint8_t* bytes)
+{
+    static_assert(std::is_unsigned_v<T>, "only unsigned integers are swapped, cast signed values");
+    T value = 0;
+    for (std::size_t index = 0; index < sizeof(T); ++index) {
+        value = static_cast<T>((value << 8U) | bytes[index]); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    return value;
+}
+
+/**
+ * @tparam T Unsigned integer type.
+ * @param value The value to store big endian.
+ * @param bytes At least sizeof(T) bytes.
+ */
+template <typename T>
+constexpr void storeBigEndian(T value, std::uint8_t* bytes)
+{
+    static_assert(std::is_unsigned_v<T>, "only unsigned integers are swapped, cast signed values");
+    for (std::size_t index = sizeof(T); index > 0; --index) {
+        bytes[index - 1] = static_cast<std::uint8_t>(value); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        value            = static_cast<T>(value >> 8U);
+    }
+}
+
+} // namespace adst::ep::gw::someip
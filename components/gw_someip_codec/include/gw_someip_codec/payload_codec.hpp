@@ -0,0 +1,344 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "gw_someip_codec/byte_order.hpp"
+#include "gw_someip_codec/someip_codec.hpp"
+#include "gw_someip_codec/span.hpp"
+
+/**
+ * @file payload_codec.hpp Serializers for SOME/IP payload structs, generated at compile time.
+ *
+ * A payload struct lists its members in wire order, the codec folds over the list:
+ *
+ *     struct Pose
+ *     {
+ *         std::uint32_t id_ = 0;
+ *         float         x_  = 0;
+ *         float         y_  = 0;
+ *         static constexpr auto FIELDS = std::make_tuple(&Pose::id_, &Pose::x_, &Pose::y_);
+ *     };
+ *
+ * Members can be integers, bools, floating point numbers, enums, std::arrays, other payload structs
+ * and ConstByteSpan. A ConstByteSpan is a dynamic length array with a 32 bit length prefix; it is
+ * deserialized as a view into the payload, nothing is copied. Everything else is fixed size, its
+ * serialized size and the offsets of its members are compile time constants.
+ */
+
+namespace adst::ep::gw::someip {
+
+namespace impl {
+
+template <typename T, typename = void>
+struct HasFields : std::false_type
+{
+};
+
+template <typename T>
+struct HasFields<T, std::void_t<decltype(T::FIELDS)>> : std::true_type
+{
+};
+
+template <typename T>
+struct IsArray : std::false_type
+{
+};
+
+template <typename T, std::size_t N>
+struct IsArray<std::array<T, N>> : std::true_type
+{
+};
+
+template <typename T>
+struct MemberOf;
+
+template <typename C, typename F>
+struct MemberOf<F C::*>
+{
+    using type = F;
+};
+
+/**
+ * Type of the member at the given position of T::FIELDS.
+ */
+template <typename T, std::size_t I>
+using FieldType = typename MemberOf<std::tuple_element_t<I, std::decay_t<decltype(T::FIELDS)>>>::type;
+
+template <typename T>
+using FloatBits = std::conditional_t<sizeof(T) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>;
+
+template <typename T>
+constexpr bool isScalar()
+{
+    return std::is_arithmetic_v<T> || std::is_enum_v<T>;
+}
+
+} // namespace impl
+
+/**
+ * @return True if all values of T serialize to the same number of bytes.
+ */
+template <typename T>
+constexpr bool isFixedSize()
+{
+    if constexpr (impl::isScalar<T>()) {
+        return true;
+    } else if constexpr (impl::IsArray<T>::value) {
+        return isFixedSize<typename T::value_type>();
+    } else if constexpr (impl::HasFields<T>::value) {
+        return std::apply(
+            [](auto... members) { return (isFixedSize<typename impl::MemberOf<decltype(members)>::type>() && ...); },
+            T::FIELDS);
+    } else {
+        static_assert(std::is_same_v<T, ConstByteSpan>, "not a payload type, see payload_codec.hpp");
+        return false;
+    }
+}
+
+/**
+ * @return Serialized size of a fixed size type.
+ */
+template <typename T>
+constexpr std::size_t fixedSize()
+{
+    static_assert(isFixedSize<T>(), "the size of the type depends on its value, use serializedSize()");
+    if constexpr (std::is_same_v<T, bool>) {
+        return 1;
+    } else if constexpr (impl::isScalar<T>()) {
+        static_assert(sizeof(T) <= sizeof(std::uint64_t), "no such SOME/IP type");
+        return sizeof(T);
+    } else if constexpr (impl::IsArray<T>::value) {
+        return std::tuple_size_v<T> * fixedSize<typename T::value_type>();
+    } else {
+        return std::apply(
+            [](auto... members) {
+                return (std::size_t{0} + ... + fixedSize<typename impl::MemberOf<decltype(members)>::type>());
+            },
+            T::FIELDS);
+    }
+}
+
+/**
+ * @param value A payload value.
+ * @return Its serialized size, a constant for fixed size types.
+ */
+template <typename T>
+constexpr std::size_t serializedSize(const T& value)
+{
+    if constexpr (isFixedSize<T>()) {
+        return fixedSize<T>();
+    } else if constexpr (std::is_same_v<T, ConstByteSpan>) {
+        return sizeof(std::uint32_t) + value.size();
+    } else if constexpr (impl::IsArray<T>::value) {
+        std::size_t size = 0;
+        for (const auto& item : value) {
+            size += serializedSize(item);
+        }
+        return size;
+    } else {
+        return std::apply([&value](auto... members) { return (std::size_t{0} + ... + serializedSize(value.*members)); },
+                          T::FIELDS);
+    }
+}
+
+namespace impl {
+
+/**
+ * @return Serialized size of the given members of T, all shall be fixed size.
+ */
+template <typename T, std::size_t... indexes>
+constexpr std::size_t sizeOfFields(std::index_sequence<indexes...>)
+{
+    return (std::size_t{0} + ... + fixedSize<FieldType<T, indexes>>());
+}
+
+} // namespace impl
+
+/**
+ * Offset of a member in the serialized struct, all members before it and the member itself shall be
+ * fixed size. Lets a gateway look at one field, e.g. an id to route on, without decoding the rest.
+ *
+ * @tparam T Payload struct.
+ * @tparam I Position of the member in T::FIELDS.
+ */
+template <typename T, std::size_t I>
+constexpr std::size_t fieldOffset()
+{
+    static_assert(isFixedSize<impl::FieldType<T, I>>(), "the member has a dynamic length");
+    return impl::sizeOfFields<T>(std::make_index_sequence<I>());
+}
+
+namespace impl {
+
+/**
+ * Writes without checks, the caller made sure serializedSize(value) bytes are left.
+ */
+template <typename T>
+void encode(const T& value, std::uint8_t*& out)
+{
+    if constexpr (std::is_same_v<T, bool>) {
+        *out++ = value ? 1 : 0; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    } else if constexpr (std::is_enum_v<T>) {
+        encode(static_cast<std::underlying_type_t<T>>(value), out);
+    } else if constexpr (std::is_integral_v<T>) {
+        storeBigEndian(static_cast<std::make_unsigned_t<T>>(value), out);
+        out += sizeof(T); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    } else if constexpr (std::is_floating_point_v<T>) {
+        FloatBits<T> bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        encode(bits, out);
+    } else if constexpr (std::is_same_v<T, ConstByteSpan>) {
+        encode(static_cast<std::uint32_t>(value.size()), out);
+        if (!value.empty()) {
+            std::memcpy(out, value.data(), value.size());
+            out += value.size(); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+    } else if constexpr (IsArray<T>::value) {
+        for (const auto& item : value) {
+            encode(item, out);
+        }
+    } else {
+        std::apply([&value, &out](auto... members) { (encode(value.*members, out), ...); }, T::FIELDS);
+    }
+}
+
+/**
+ * Reads without checks, the caller made sure fixedSize<T>() bytes are left.
+ */
+template <typename T>
+void decodeFixed(const std::uint8_t*& in, T& value)
+{
+    if constexpr (std::is_same_v<T, bool>) {
+        value = *in++ != 0; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    } else if constexpr (std::is_enum_v<T>) {
+        std::underlying_type_t<T> raw = {};
+        decodeFixed(in, raw);
+        value = static_cast<T>(raw);
+    } else if constexpr (std::is_integral_v<T>) {
+        value = static_cast<T>(loadBigEndian<std::make_unsigned_t<T>>(in));
+        in += sizeof(T); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    } else if constexpr (std::is_floating_point_v<T>) {
+        FloatBits<T> bits = 0;
+        decodeFixed(in, bits);
+        std::memcpy(&value, &bits, sizeof(bits));
+    } else if constexpr (IsArray<T>::value) {
+        for (auto& item : value) {
+            decodeFixed(in, item);
+        }
+    } else {
+        std::apply([&value, &in](auto... members) { (decodeFixed(in, value.*members), ...); }, T::FIELDS);
+    }
+}
+
+/**
+ * Reads with one bounds check per fixed size part.
+ * @return False if the payload ends early.
+ */
+template <typename T>
+bool decode(const std::uint8_t*& in, const std::uint8_t* end, T& value)
+{
+    if constexpr (isFixedSize<T>()) {
+        if (static_cast<std::size_t>(end - in) < fixedSize<T>()) {
+            return false;
+        }
+        decodeFixed(in, value);
+        return true;
+    } else if constexpr (std::is_same_v<T, ConstByteSpan>) {
+        std::uint32_t size = 0;
+        if (!decode(in, end, size) || static_cast<std::size_t>(end - in) < size) {
+            return false;
+        }
+        value = {in, size};
+        in += size; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return true;
+    } else if constexpr (IsArray<T>::value) {
+        for (auto& item : value) {
+            if (!decode(in, end, item)) {
+                return false;
+            }
+        }
+        return true;
+    } else {
+        return std::apply([&value, &in, end](auto... members) { return (decode(in, end, value.*members) && ...); },
+                          T::FIELDS);
+    }
+}
+
+} // namespace impl
+
+/**
+ * @param value The payload.
+ * @param buffer Where to write it.
+ * @return The bytes written, 0 if the buffer is too small.
+ */
+template <typename T>
+std::size_t serialize(const T& value, ByteSpan buffer)
+{
+    const auto size = serializedSize(value);
+    if (size > buffer.size()) {
+        return 0;
+    }
+    auto* out = buffer.data();
+    impl::encode(value, out);
+    return size;
+}
+
+/**
+ * @param payload Payload of a received message, see MessageView::payload().
+ * @param value Set from the payload. Its ConstByteSpan members point into the payload.
+ * @return False if the payload is too short, value is partly set then.
+ */
+template <typename T>
+bool deserialize(ConstByteSpan payload, T& value)
+{
+    const auto* in = payload.data();
+    return impl::decode(in, payload.data() + payload.size(), value);
+}
+
+/**
+ * Reads one member of a payload struct in place, see fieldOffset().
+ * @tparam I Position of the member in T::FIELDS.
+ * @tparam T Payload struct.
+ * @param payload Payload of a received message.
+ * @param field Set to the member.
+ * @return False if the payload is too short.
+ */
+template <std::size_t I, typename T>
+bool readField(ConstByteSpan payload, impl::FieldType<T, I>& field)
+{
+    using Field           = impl::FieldType<T, I>;
+    constexpr auto offset = fieldOffset<T, I>();
+    if (payload.size() < offset + fixedSize<Field>()) {
+        return false;
+    }
+    const auto* in = payload.data() + offset;
+    impl::decodeFixed(in, field);
+    return true;
+}
+
+/**
+ * Writes a complete message, header and payload.
+ * @param buffer Send buffer.
+ * @param header The header fields, the length is derived from the payload.
+ * @param payload The payload struct.
+ * @return Size of the message, 0 if the buffer is too small.
+ */
+template <typename T>
+std::size_t buildMessage(ByteSpan buffer, const Header& header, const T& payload)
+{
+    const auto size = serializedSize(payload);
+    if (writeHeader(buffer, header, size) == 0) {
+        return 0;
+    }
+    auto* out = buffer.data() + HEADER_SIZE;
+    impl::encode(payload, out);
+    return HEADER_SIZE + size;
+}
+
+} // namespace adst::ep::gw::someip
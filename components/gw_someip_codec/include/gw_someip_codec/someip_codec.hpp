@@ -0,0 +1,236 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gw_someip_codec/byte_order.hpp"
+#include "gw_someip_codec/span.hpp"
+
+namespace adst::ep::gw::someip {
+
+constexpr std::size_t   HEADER_SIZE      = 16; /// message id, length, request id, versions, type, return code
+constexpr std::size_t   LENGTH_OFFSET    = 8;  /// the length field counts the bytes from here on
+constexpr std::uint8_t  PROTOCOL_VERSION = 1;  /// the only SOME/IP protocol version defined
+constexpr std::uint32_t MIN_LENGTH       = HEADER_SIZE - LENGTH_OFFSET; /// length of a message without payload
+
+enum class MessageType : std::uint8_t
+{
+    REQUEST              = 0x00,
+    REQUEST_NO_RETURN    = 0x01,
+    NOTIFICATION         = 0x02,
+    TP_REQUEST           = 0x20,
+    TP_REQUEST_NO_RETURN = 0x21,
+    TP_NOTIFICATION      = 0x22,
+    RESPONSE             = 0x80,
+    ERROR                = 0x81,
+    TP_RESPONSE          = 0xa0,
+    TP_ERROR             = 0xa1,
+};
+
+enum class ReturnCode : std::uint8_t
+{
+    E_OK                      = 0x00,
+    E_NOT_OK                  = 0x01,
+    E_UNKNOWN_SERVICE         = 0x02,
+    E_UNKNOWN_METHOD          = 0x03,
+    E_NOT_READY               = 0x04,
+    E_NOT_REACHABLE           = 0x05,
+    E_TIMEOUT                 = 0x06,
+    E_WRONG_PROTOCOL_VERSION  = 0x07,
+    E_WRONG_INTERFACE_VERSION = 0x08,
+    E_MALFORMED_MESSAGE       = 0x09,
+    E_WRONG_MESSAGE_TYPE      = 0x0a,
+};
+
+enum class ParseStatus
+{
+    OK,
+    TRUNCATED_HEADER,       /// less than HEADER_SIZE bytes left
+    TRUNCATED_PAYLOAD,      /// the length field reaches beyond the buffer
+    BAD_LENGTH,             /// the length field is below MIN_LENGTH
+    WRONG_PROTOCOL_VERSION, /// the protocol version is not PROTOCOL_VERSION
+};
+
+/**
+ * Header fields of an outgoing message. The length is not part of it, writeHeader() derives it from
+ * the payload size.
+ */
+struct Header
+{
+    std::uint16_t serviceId_        = 0;
+    std::uint16_t methodId_         = 0;
+    std::uint16_t clientId_         = 0;
+    std::uint16_t sessionId_        = 0;
+    std::uint8_t  protocolVersion_  = PROTOCOL_VERSION;
+    std::uint8_t  interfaceVersion_ = 0;
+    MessageType   messageType_      = MessageType::NOTIFICATION;
+    ReturnCode    returnCode_       = ReturnCode::E_OK;
+};
+
+/**
+ * One SOME/IP message inside a receive buffer. Nothing is copied, the fields are decoded from the
+ * buffer on each access, so the buffer shall outlive the view and shall not be reused meanwhile.
+ */
+class MessageView
+{
+public:
+    MessageView() = default;
+
+    /**
+     * @param bytes Exactly one complete message, as checked by parse().
+     */
+    explicit MessageView(ConstByteSpan bytes)
+        : bytes_(bytes)
+    {
+    }
+
+    std::uint16_t serviceId() const
+    {
+        return loadBigEndian<std::uint16_t>(bytes_.data());
+    }
+
+    std::uint16_t methodId() const
+    {
+        return loadBigEndian<std::uint16_t>(bytes_.data() + 2);
+    }
+
+    /**
+     * @return Service and method id together, the key to route a message on.
+     */
+    std::uint32_t messageId() const
+    {
+        return loadBigEndian<std::uint32_t>(bytes_.data());
+    }
+
+    /**
+     * @return Bytes following the length field, MIN_LENGTH plus the payload size.
+     */
+    std::uint32_t length() const
+    {
+        return loadBigEndian<std::uint32_t>(bytes_.data() + 4);
+    }
+
+    std::uint16_t clientId() const
+    {
+        return loadBigEndian<std::uint16_t>(bytes_.data() + 8);
+    }
+
+    std::uint16_t sessionId() const
+    {
+        return loadBigEndian<std::uint16_t>(bytes_.data() + 10);
+    }
+
+    /**
+     * @return Client and session id together, matches a response to its request.
+     */
+    std::uint32_t requestId() const
+    {
+        return loadBigEndian<std::uint32_t>(bytes_.data() + 8);
+    }
+
+    std::uint8_t protocolVersion() const
+    {
+        return bytes_[12];
+    }
+
+    std::uint8_t interfaceVersion() const
+    {
+        return bytes_[13];
+    }
+
+    MessageType messageType() const
+    {
+        return static_cast<MessageType>(bytes_[14]);
+    }
+
+    ReturnCode returnCode() const
+    {
+        return static_cast<ReturnCode>(bytes_[15]);
+    }
+
+    /**
+     * @return Copy of the header fields, e.g. to answer with the same ids.
+     */
+    Header header() const
+    {
+        return {serviceId(),       methodId(),       clientId(),    sessionId(),
+                protocolVersion(), interfaceVersion(), messageType(), returnCode()};
+    }
+
+    /**
+     * @return The payload, a view into the receive buffer.
+     */
+    ConstByteSpan payload() const
+    {
+        return bytes_.subspan(HEADER_SIZE);
+    }
+
+    /**
+     * @return The whole message, header and payload.
+     */
+    ConstByteSpan bytes() const
+    {
+        return bytes_;
+    }
+
+private:
+    ConstByteSpan bytes_;
+};
+
+/**
+ * Checks the message at the start of the buffer.
+ * @param buffer Receive buffer, may hold more messages after the first one.
+ * @param message Set to the first message when OK is returned, untouched otherwise.
+ * @return OK or why the buffer does not start with a valid message.
+ */
+ParseStatus parse(ConstByteSpan buffer, MessageView& message);
+
+/**
+ * Writes the header in front of a payload which is, or will be, at buffer[HEADER_SIZE].
+ * @param buffer Send buffer.
+ * @param header The header fields.
+ * @param payloadSize Size of the payload, sets the length field.
+ * @return HEADER_SIZE, 0 if the buffer can not hold header and payload.
+ */
+std::size_t writeHeader(ByteSpan buffer, const Header& header, std::size_t payloadSize);
+
+/**
+ * Walks the messages packed back to back into one buffer, like the messages of a UDP datagram or a
+ * chunk of a TCP stream.
+ */
+class MessageReader
+{
+public:
+    explicit MessageReader(ConstByteSpan buffer)
+        : rest_(buffer)
+    {
+    }
+
+    /**
+     * @param message Set to the next message when true is returned.
+     * @return False at the end of the buffer or at the first invalid message, see status().
+     */
+    bool next(MessageView& message);
+
+    /**
+     * @return OK while messages are read and at a clean end, the parse error otherwise.
+     */
+    ParseStatus status() const
+    {
+        return status_;
+    }
+
+    /**
+     * @return The bytes not read yet, e.g. the start of a message continued in the next TCP chunk.
+     */
+    ConstByteSpan rest() const
+    {
+        return rest_;
+    }
+
+private:
+    ConstByteSpan rest_;
+    ParseStatus   status_ = ParseStatus::OK;
+};
+
+} // namespace adst::ep::gw::someip
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace adst::ep::gw::someip {
+
+/**
+ * Non owning view over a contiguous range, the subset of C++20 std::span the codec needs. The
+ * components are built as C++17, replace it with std::span once the project moves on.
+ *
+ * @tparam T Element type, const qualified for read only views.
+ */
+template <typename T>
+class Span
+{
+public:
+    constexpr Span() = default;
+
+    constexpr Span(T* data, std::size_t size)
+        : data_(data)
+        , size_(size)
+    {
+    }
+
+    template <std::size_t N>
+    constexpr Span(T (&array)[N]) // NOLINT(google-explicit-constructor) implicit like std::span
+        : data_(array)
+        , size_(N)
+    {
+    }
+
+    /**
+     * A writable view converts to a read only one.
+     */
+    template <typename U>
+    constexpr Span(const Span<U>& other) // NOLINT(google-explicit-constructor) implicit like std::span
+        : data_(other.data())
+        , size_(other.size())
+    {
+    }
+
+    constexpr T* data() const
+    {
+        return data_;
+    }
+
+    constexpr std::size_t size() const
+    {
+        return size_;
+    }
+
+    constexpr bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    constexpr T* begin() const
+    {
+        return data_;
+    }
+
+    constexpr T* end() const
+    {
+        return data_ + size_;
+    }
+
+    /**
+     * @param index Shall be below size().
+     */
+    constexpr T& operator[](std::size_t index) const
+    {
+        return data_[index];
+    }
+
+    /**
+     * @param offset First element of the view, shall not be above size().
+     * @param count Elements in the view, shall not reach beyond the end.
+     * @return View over a part of this one.
+     */
+    constexpr Span subspan(std::size_t offset, std::size_t count) const
+    {
+        return {data_ + offset, count};
+    }
+
+    /**
+     * @param offset First element of the view, shall not be above size().
+     * @return View from offset till the end of this one.
+     */
+    constexpr Span subspan(std::size_t offset) const
+    {
+        return {data_ + offset, size_ - offset};
+    }
+
+private:
+    T*          data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+using ByteSpan      = Span<std::uint8_t>;       /// writable bytes, e.g. a send buffer
+using ConstByteSpan = Span<const std::uint8_t>; /// read only bytes, e.g. a receive buffer
+
+} // namespace adst::ep::gw::someip
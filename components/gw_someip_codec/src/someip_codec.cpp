@@ -0,0 +1,55 @@
+#include "gw_someip_codec/someip_codec.hpp"
+
+namespace adst::ep::gw::someip {
+
+ParseStatus parse(ConstByteSpan buffer, MessageView& message)
+{
+    if (buffer.size() < HEADER_SIZE) {
+        return ParseStatus::TRUNCATED_HEADER;
+    }
+    const auto length = loadBigEndian<std::uint32_t>(buffer.data() + 4);
+    if (length < MIN_LENGTH) {
+        return ParseStatus::BAD_LENGTH;
+    }
+    if (length > buffer.size() - LENGTH_OFFSET) {
+        return ParseStatus::TRUNCATED_PAYLOAD;
+    }
+    if (buffer[12] != PROTOCOL_VERSION) {
+        return ParseStatus::WRONG_PROTOCOL_VERSION;
+    }
+    message = MessageView(buffer.subspan(0, LENGTH_OFFSET + length));
+    return ParseStatus::OK;
+}
+
+std::size_t writeHeader(ByteSpan buffer, const Header& header, std::size_t payloadSize)
+{
+    if (buffer.size() < HEADER_SIZE || payloadSize > buffer.size() - HEADER_SIZE) {
+        return 0;
+    }
+    auto* bytes = buffer.data();
+    storeBigEndian(header.serviceId_, bytes);
+    storeBigEndian(header.methodId_, bytes + 2);
+    storeBigEndian(static_cast<std::uint32_t>(MIN_LENGTH + payloadSize), bytes + 4);
+    storeBigEndian(header.clientId_, bytes + 8);
+    storeBigEndian(header.sessionId_, bytes + 10);
+    bytes[12] = header.protocolVersion_;
+    bytes[13] = header.interfaceVersion_;
+    bytes[14] = static_cast<std::uint8_t>(header.messageType_);
+    bytes[15] = static_cast<std::uint8_t>(header.returnCode_);
+    return HEADER_SIZE;
+}
+
+bool MessageReader::next(MessageView& message)
+{
+    if (rest_.empty() || status_ != ParseStatus::OK) {
+        return false;
+    }
+    status_ = parse(rest_, message);
+    if (status_ != ParseStatus::OK) {
+        return false;
+    }
+    rest_ = rest_.subspan(message.bytes().size());
+    return true;
+}
+
+} // namespace adst::ep::gw::someip
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "gtest/gtest.h"
+
+#include "adstutil_cxx/gtest_util.hpp"
+#include "gw_someip_codec/payload_codec.hpp"
+#include "gw_someip_codec/someip_codec.hpp"
+
+using adst::ep::gw::someip::buildMessage;
+using adst::ep::gw::someip::ByteSpan;
+using adst::ep::gw::someip::ConstByteSpan;
+using adst::ep::gw::someip::deserialize;
+using adst::ep::gw::someip::fieldOffset;
+using adst::ep::gw::someip::fixedSize;
+using adst::ep::gw::someip::Header;
+using adst::ep::gw::someip::HEADER_SIZE;
+using adst::ep::gw::someip::isFixedSize;
+using adst::ep::gw::someip::MessageReader;
+using adst::ep::gw::someip::MessageType;
+using adst::ep::gw::someip::MessageView;
+using adst::ep::gw::someip::parse;
+using adst::ep::gw::someip::ParseStatus;
+using adst::ep::gw::someip::readField;
+using adst::ep::gw::someip::ReturnCode;
+using adst::ep::gw::someip::serialize;
+using adst::ep::gw::someip::serializedSize;
+using adst::ep::gw::someip::writeHeader;
+
+namespace {
+
+enum class Gear : std::uint8_t
+{
+    PARK    = 0,
+    DRIVE   = 3,
+    REVERSE = 7,
+};
+
+struct Pose
+{
+    std::int32_t x_       = 0;
+    std::int32_t y_       = 0;
+    float        heading_ = 0;
+
+    static constexpr auto FIELDS = std::make_tuple(&Pose::x_, &Pose::y_, &Pose::heading_);
+};
+
+struct VehicleState
+{
+    std::uint16_t               id_     = 0;
+    bool                        moving_ = false;
+    Gear                        gear_   = Gear::PARK;
+    Pose                        pose_;
+    std::array<std::uint8_t, 3> flags_ = {};
+    double                      speed_ = 0;
+    ConstByteSpan               comment_;
+
+    static constexpr auto FIELDS = std::make_tuple(&VehicleState::id_, &VehicleState::moving_, &VehicleState::gear_,
+                                                   &VehicleState::pose_, &VehicleState::flags_, &VehicleState::speed_,
+                                                   &VehicleState::comment_);
+};
+
+static_assert(isFixedSize<Pose>());
+static_assert(fixedSize<Pose>() == 12);
+static_assert(!isFixedSize<VehicleState>());
+static_assert(fieldOffset<VehicleState, 3>() == 4);
+static_assert(fieldOffset<VehicleState, 5>() == 19);
+
+constexpr Header HEADER = {0x1234, 0x8001, 0x0042, 0x0007, 1, 2, MessageType::NOTIFICATION, ReturnCode::E_OK};
+
+} // namespace
+
+TEST(SomeIpCodec, HeaderRoundTrip) // NOLINT
+{
+    std::array<std::uint8_t, HEADER_SIZE + 4> buffer = {};
+    ASSERT_EQ(writeHeader({buffer.data(), buffer.size()}, HEADER, 4), HEADER_SIZE); // NOLINT
+    const std::array<std::uint8_t, HEADER_SIZE> expected = {0x12, 0x34, 0x80, 0x01, 0x00, 0x00, 0x00, 0x0c,
+                                                            0x00, 0x42, 0x00, 0x07, 0x01, 0x02, 0x02, 0x00};
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin()));
+
+    MessageView message;
+    ASSERT_EQ(parse({buffer.data(), buffer.size()}, message), ParseStatus::OK); // NOLINT
+    EXPECT_EQ_NOLINT(message.serviceId(), 0x1234);
+    EXPECT_EQ_NOLINT(message.methodId(), 0x8001);
+    EXPECT_EQ_NOLINT(message.messageId(), 0x12348001U);
+    EXPECT_EQ_NOLINT(message.length(), 12U);
+    EXPECT_EQ_NOLINT(message.requestId(), 0x00420007U);
+    EXPECT_EQ_NOLINT(message.interfaceVersion(), 2);
+    EXPECT_EQ_NOLINT(message.messageType(), MessageType::NOTIFICATION);
+    EXPECT_EQ_NOLINT(message.returnCode(), ReturnCode::E_OK);
+    EXPECT_EQ_NOLINT(message.payload().size(), 4U);
+    EXPECT_EQ_NOLINT(message.payload().data(), buffer.data() + HEADER_SIZE); // a view, not a copy
+
+    EXPECT_EQ_NOLINT(writeHeader({buffer.data(), buffer.size()}, HEADER, 5), 0U);
+}
+
+TEST(SomeIpCodec, ParseErrors) // NOLINT
+{
+    std::array<std::uint8_t, HEADER_SIZE + 4> buffer = {};
+    writeHeader({buffer.data(), buffer.size()}, HEADER, 4);
+    MessageView message;
+    EXPECT_EQ_NOLINT(parse({buffer.data(), HEADER_SIZE - 1}, message), ParseStatus::TRUNCATED_HEADER);
+    EXPECT_EQ_NOLINT(parse({buffer.data(), HEADER_SIZE + 3}, message), ParseStatus::TRUNCATED_PAYLOAD);
+    buffer[7] = 7;
+    EXPECT_EQ_NOLINT(parse({buffer.data(), buffer.size()}, message), ParseStatus::BAD_LENGTH);
+    buffer[7] = 8;
+    buffer[12] = 2;
+    EXPECT_EQ_NOLINT(parse({buffer.data(), buffer.size()}, message), ParseStatus::WRONG_PROTOCOL_VERSION);
+}
+
+TEST(SomeIpCodec, PayloadRoundTrip) // NOLINT
+{
+    const std::array<std::uint8_t, 5> comment = {'h', 'e', 'l', 'l', 'o'};
+    VehicleState state;
+    state.id_      = 0xbeef;
+    state.moving_  = true;
+    state.gear_    = Gear::REVERSE;
+    state.pose_    = {-5, 1000000, 1.5F};
+    state.flags_   = {1, 2, 3};
+    state.speed_   = -12.25;
+    state.comment_ = {comment.data(), comment.size()};
+    ASSERT_EQ(serializedSize(state), 19U + 8U + 4U + comment.size()); // NOLINT
+
+    std::vector<std::uint8_t> buffer(HEADER_SIZE + serializedSize(state));
+    ASSERT_EQ(buildMessage(ByteSpan{buffer.data(), buffer.size()}, HEADER, state), buffer.size()); // NOLINT
+    EXPECT_EQ_NOLINT(buildMessage(ByteSpan{buffer.data(), buffer.size() - 1}, HEADER, state), 0U);
+
+    MessageView message;
+    ASSERT_EQ(parse({buffer.data(), buffer.size()}, message), ParseStatus::OK); // NOLINT
+    VehicleState decoded;
+    ASSERT_TRUE(deserialize(message.payload(), decoded));
+    EXPECT_EQ_NOLINT(decoded.id_, 0xbeef);
+    EXPECT_TRUE(decoded.moving_);
+    EXPECT_EQ_NOLINT(decoded.gear_, Gear::REVERSE);
+    EXPECT_EQ_NOLINT(decoded.pose_.x_, -5);
+    EXPECT_EQ_NOLINT(decoded.pose_.y_, 1000000);
+    EXPECT_EQ_NOLINT(decoded.pose_.heading_, 1.5F);
+    EXPECT_EQ_NOLINT(decoded.flags_[2], 3);
+    EXPECT_EQ_NOLINT(decoded.speed_, -12.25);
+    ASSERT_EQ(decoded.comment_.size(), comment.size()); // NOLINT
+    EXPECT_EQ_NOLINT(decoded.comment_.data(), buffer.data() + buffer.size() - comment.size()); // a view, not a copy
+
+    Pose pose;
+    ASSERT_TRUE((readField<3, VehicleState>(message.payload(), pose)));
+    EXPECT_EQ_NOLINT(pose.y_, 1000000);
+
+    EXPECT_FALSE(deserialize(message.payload().subspan(0, message.payload().size() - 1), decoded));
+    std::array<std::uint8_t, 4> small = {};
+    EXPECT_EQ_NOLINT(serialize(state, ByteSpan{small.data(), small.size()}), 0U);
+}
+
+TEST(SomeIpCodec, ReaderWalksDatagram) // NOLINT
+{
+    std::array<std::uint8_t, 2 * (HEADER_SIZE + 4) + HEADER_SIZE> datagram = {};
+    ByteSpan rest = {datagram.data(), datagram.size()};
+    for (std::uint16_t session = 1; session <= 2; ++session) {
+        Header header     = HEADER;
+        header.sessionId_ = session;
+        const auto size   = buildMessage(rest, header, std::uint32_t{session});
+        ASSERT_EQ(size, HEADER_SIZE + 4); // NOLINT
+        rest = rest.subspan(size);
+    }
+    writeHeader(rest, HEADER, 0);
+
+    // the third message is cut off, like at the end of a TCP chunk
+    MessageReader              reader({datagram.data(), datagram.size() - 6});
+    MessageView                message;
+    std::vector<std::uint16_t> sessions;
+    while (reader.next(message)) {
+        sessions.push_back(message.sessionId());
+    }
+    EXPECT_EQ_NOLINT(sessions, (std::vector<std::uint16_t>{1, 2}));
+    EXPECT_EQ_NOLINT(reader.status(), ParseStatus::TRUNCATED_HEADER);
+    EXPECT_EQ_NOLINT(reader.rest().size(), HEADER_SIZE - 6);
+}
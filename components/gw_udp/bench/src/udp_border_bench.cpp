@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include "config_cxx/config_and_logger.hpp"
+#include "core/core.hpp"
+#include "gw_someip_codec/payload_codec.hpp"
+#include "gw_someip_codec/someip_codec.hpp"
+#include "gw_udp/udp_border.hpp"
+
+using adst::common::Config;
+using adst::common::ConfigAndLogger;
+using adst::common::Error;
+using adst::ep::gw::someip::buildMessage;
+using adst::ep::gw::someip::ByteSpan;
+using adst::ep::gw::someip::Header;
+using adst::ep::gw::udp::SomeIpBatch;
+using adst::ep::gw::udp::UdpBorder;
+using adst::ep::gw::udp::UdpEndpoint;
+using adst::ep::gw::udp::UdpSettings;
+using adst::ep::test_engine::core::Actor;
+using adst::ep::test_engine::core::Core;
+using adst::ep::test_engine::core::Environment;
+using adst::ep::test_engine::core::StartCnf;
+using adst::ep::test_engine::core::Stop;
+
+namespace {
+
+constexpr int         DISPATCHER_COUNT = 4;
+constexpr std::size_t PEER_COUNT       = 8;     /// sending sockets, the kernel spreads them over the shards
+constexpr std::size_t WINDOW           = 16;    /// datagrams each peer keeps in flight, fits the socket buffers
+constexpr std::size_t DATAGRAM_COUNT   = 50000; /// datagrams received in one run of the core
+constexpr std::size_t PAYLOAD_SIZE     = 64;    /// bytes of payload of each message
+
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const adst::common::OnErrorCallBack onError = [](const Error& error) {
+    std::cerr << error.errorCodeName_.second << std::endl;
+    exit(1);
+};
+
+/**
+ * How the shards receive: their own threads or the I/O engines of the dispatchers.
+ */
+enum class Mode
+{
+    THREADS,
+    EPOLL,
+    IO_URING
+};
+
+const ConfigAndLogger& getConfigAndLogger(Mode mode)
+{
+    static const ConfigAndLogger threads = {Config{onError, DISPATCHER_COUNT}};
+    static const ConfigAndLogger epoll   = {Config{onError, DISPATCHER_COUNT, "", "dispatchers: {normal: {io: epoll}}"}};
+    static const ConfigAndLogger uring   = {Config{onError, DISPATCHER_COUNT, "", "dispatchers: {normal: {io: uring}}"}};
+    switch (mode) {
+        case Mode::EPOLL:
+            return epoll;
+        case Mode::IO_URING:
+            return uring;
+        default:
+            return threads;
+    }
+}
+
+/**
+ * Load generator: a UDP socket sending the same notification with sendmmsg.
+ */
+class Peer
+{
+public:
+    Peer(const Peer&) = delete;
+    Peer& operator=(const Peer&) = delete;
+    Peer(Peer&&)                 = delete;
+    Peer& operator=(Peer&&) = delete;
+
+    explicit Peer(std::uint16_t port)
+        : socket_(::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0))
+    {
+        sockaddr_in local     = {};
+        local.sin_family      = AF_INET;
+        local.sin_addr.s_addr = htonl(UdpEndpoint::LOOPBACK);
+        ::bind(socket_, reinterpret_cast<const sockaddr*>(&local), sizeof(local)); // NOLINT
+        socklen_t length = sizeof(local);
+        ::getsockname(socket_, reinterpret_cast<sockaddr*>(&local), &length); // NOLINT
+        port_ = ntohs(local.sin_port);
+
+        target_.sin_family      = AF_INET;
+        target_.sin_addr.s_addr = htonl(UdpEndpoint::LOOPBACK);
+        target_.sin_port        = htons(port);
+        const std::array<std::uint8_t, PAYLOAD_SIZE> payload = {};
+        buildMessage(ByteSpan{datagram_.data(), datagram_.size()}, Header{0x0100, 0x8001}, payload);
+        for (std::size_t index = 0; index < WINDOW; ++index) {
+            headers_[index].msg_hdr.msg_name    = &target_;
+            headers_[index].msg_hdr.msg_namelen = sizeof(target_);
+            headers_[index].msg_hdr.msg_iov     = &vector_;
+            headers_[index].msg_hdr.msg_iovlen  = 1;
+        }
+    }
+
+    ~Peer()
+    {
+        ::close(socket_);
+    }
+
+    /**
+     * @param count Datagrams to send, at most WINDOW.
+     */
+    void send(std::size_t count)
+    {
+        for (std::size_t sent = 0; sent < count;) {
+            const int result = ::sendmmsg(socket_, headers_.data() + sent, static_cast<unsigned>(count - sent), 0);
+            if (result < 0) {
+                onError(Error{{8, "Peer: sendmmsg failed"}});
+            }
+            sent += static_cast<std::size_t>(result);
+        }
+    }
+
+    std::uint16_t getPort() const
+    {
+        return port_;
+    }
+
+private:
+    int                                                         socket_;
+    std::uint16_t                                               port_   = 0;
+    sockaddr_in                                                 target_ = {};
+    std::array<std::uint8_t, adst::ep::gw::someip::HEADER_SIZE + PAYLOAD_SIZE> datagram_ = {};
+    iovec                                                       vector_ = {datagram_.data(), datagram_.size()};
+    std::array<mmsghdr, WINDOW>                                 headers_ = {};
+};
+
+/**
+ * Keeps WINDOW datagrams of each peer in flight till DATAGRAM_COUNT arrived: each batch received
+ * from a peer is answered by as many new datagrams of that peer.
+ */
+struct UdpBenchRoot : public Actor
+{
+    // not copyable or movable
+    UdpBenchRoot(const UdpBenchRoot&) = delete;
+    UdpBenchRoot(UdpBenchRoot&&)      = delete;
+
+    UdpBenchRoot& operator=(const UdpBenchRoot&) = delete;
+    UdpBenchRoot& operator=(UdpBenchRoot&&) = delete;
+
+    using SelfStartCnf = StartCnf<UdpBenchRoot>;
+
+    UdpBenchRoot(const Environment& env, const UdpSettings& settings)
+        : Actor(NAME.c_str(), env)
+    {
+        const auto border = newChild<UdpBorder>(settings);
+        const auto port   = static_cast<const UdpBorder&>(getChild(border)).getLocalPort();
+        for (std::size_t peer = 0; peer < PEER_COUNT; ++peer) {
+            peers_.push_back(std::make_unique<Peer>(port));
+            peerOfPort_[peers_.back()->getPort()] = peers_.back().get();
+        }
+        listen<SelfStartCnf>([this](const SelfStartCnf&) {
+            for (auto& peer : peers_) {
+                peer->send(WINDOW);
+            }
+            sent_ = WINDOW * PEER_COUNT;
+        });
+        listen<SomeIpBatch>([this](const SomeIpBatch& batch) {
+            const auto& messages = batch.getMessages();
+            received_ += messages.size();
+            if (received_ >= DATAGRAM_COUNT) {
+                publish(std::make_unique<Stop>());
+                return;
+            }
+            // all messages of a batch come from the peers hashed to one shard, count them per peer
+            for (std::size_t first = 0; first < messages.size();) {
+                std::size_t last = first + 1;
+                while (last < messages.size() && messages[last].peer_ == messages[first].peer_) {
+                    ++last;
+                }
+                const auto count = std::min(last - first, DATAGRAM_COUNT - std::min(sent_, DATAGRAM_COUNT));
+                peerOfPort_[messages[first].peer_.port_]->send(count);
+                sent_ += count;
+                first = last;
+            }
+        });
+    }
+    ~UdpBenchRoot() override = default;
+
+    std::vector<std::unique_ptr<Peer>> peers_;
+    std::map<std::uint16_t, Peer*>     peerOfPort_;
+    std::size_t                        sent_     = 0;
+    std::size_t                        received_ = 0;
+
+    static constexpr const auto NAME = sstr::literal("UdpBenchRoot");
+};
+
+/**
+ * Datagrams per second through loopback into SomeIpBatch events. Arguments are the shard count, the
+ * batch size and the Mode. Batch size 1 is the datagram by datagram baseline. With an I/O engine the
+ * engine reads as many datagrams as it has buffers, the batch size only splits them into events.
+ */
+void BM_UdpBorderReceive(benchmark::State& state)
+{
+    const auto  mode = static_cast<Mode>(state.range(2));
+    UdpSettings settings;
+    settings.local_     = {UdpEndpoint::LOOPBACK, 0};
+    settings.shards_    = static_cast<std::size_t>(state.range(0));
+    settings.batchSize_ = static_cast<std::size_t>(state.range(1));
+    settings.receiveBufferSize_ = 1 << 20;
+    settings.ioEngine_          = mode != Mode::THREADS;
+    for (auto _ : state) {
+        Core core(getConfigAndLogger(mode));
+        core.init<UdpBenchRoot>(settings);
+        core.run();
+    }
+    const auto datagrams = static_cast<std::int64_t>(state.iterations() * DATAGRAM_COUNT);
+    state.SetItemsProcessed(datagrams);
+    state.SetBytesProcessed(datagrams
+                            * static_cast<std::int64_t>(adst::ep::gw::someip::HEADER_SIZE + PAYLOAD_SIZE));
+}
+
+} // namespace
+
+BENCHMARK(BM_UdpBorderReceive)
+    ->ArgsProduct({{1, 2, 4}, {1, 8, 32}, {static_cast<int>(Mode::THREADS), static_cast<int>(Mode::EPOLL),
+                                            static_cast<int>(Mode::IO_URING)}})
+    ->ArgNames({"shards", "batch", "io"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
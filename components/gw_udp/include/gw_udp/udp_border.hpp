@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/core.hpp"
+#include "gw_udp/udp_messages.hpp"
+
+namespace adst::ep::gw::udp {
+
+namespace impl {
+class UdpShard;
+} // namespace impl
+
+/**
+ * Socket level settings of a UdpBorder.
+ */
+struct UdpSettings
+{
+    UdpEndpoint local_;                     /// where to bind, port 0 lets the system pick one for all shards
+    std::size_t shards_            = 1;     /// sockets bound to the same port with SO_REUSEPORT
+    std::size_t batchSize_         = 32;    /// datagrams per recvmmsg and sendmmsg call
+    std::size_t maxDatagram_       = 1500;  /// receive buffer per datagram, longer ones count as malformed
+    std::size_t ringDepth_         = 8;     /// batches a shard can have in flight before it stops receiving
+    int         receiveBufferSize_ = 0;     /// SO_RCVBUF, 0 keeps the system default
+    bool        ioEngine_          = false; /// receive through the I/O engines of the dispatchers, not threads
+};
+
+/**
+ * Counters of a UdpBorder summed over its shards.
+ */
+struct UdpStats
+{
+    std::uint64_t batches_     = 0; /// SomeIpBatch events published
+    std::uint64_t datagrams_   = 0; /// datagrams received
+    std::uint64_t malformed_   = 0; /// received datagrams not (completely) parsed as SOME/IP
+    std::uint64_t ringFull_    = 0; /// times the next slot of the ring of a shard was still held
+    std::uint64_t sent_        = 0; /// datagrams sent
+    std::uint64_t sendDropped_ = 0; /// datagrams not sent, the socket buffer was full or sendmmsg failed
+};
+
+/**
+ * Border between a UDP port and the network of the actors, carrying SOME/IP.
+ *
+ * Each shard is a socket bound with SO_REUSEPORT, so the kernel spreads the peers over the shards,
+ * with a receive thread and a ring of preallocated batch slots. The thread sleeps in poll() and on
+ * each wake-up drains the socket with recvmmsg, batchSize_ datagrams at a time, decodes the messages
+ * in place and publishes them as one SomeIpBatch. Listeners which care about cache locality can
+ * filter on SomeIpBatch::getShard() and pin themselves to a dispatcher, one per shard.
+ *
+ * With UdpSettings::ioEngine_ the shards have no threads. Each shard (at most MAX_IO_ENGINE_SHARDS)
+ * is received by a child actor bound to dispatcher number shard, through the I/O engine of that
+ * dispatcher (io_uring or epoll, see Actor::receive()), so the priority of the border needs an io
+ * backend in the config. The datagrams are copied into the ring slot, a slot still held is replaced
+ * by a new one instead of waiting, as the dispatcher shall not block.
+ *
+ * SomeIpSend events are sent by the border in actor context with sendmmsg. Sockets are bound in the
+ * constructor, so errors (e.g. the port is taken) are reported before the core runs; the shards
+ * receive between the start and the stop of the actor.
+ *
+ * Linux only, recvmmsg and sendmmsg are not POSIX.
+ */
+class UdpBorder : public test_engine::core::Actor
+{
+public:
+    // not copyable or movable
+    UdpBorder(const UdpBorder&) = delete;
+    UdpBorder(UdpBorder&&)      = delete;
+
+    UdpBorder& operator=(const UdpBorder&) = delete;
+    UdpBorder& operator=(UdpBorder&&) = delete;
+
+    UdpBorder(const test_engine::core::Environment& env, const UdpSettings& settings);
+    ~UdpBorder() override;
+
+    /**
+     * @return The port the shards are bound to, the one picked by the system for port 0.
+     */
+    std::uint16_t getLocalPort() const;
+
+    /**
+     * The counters are updated without a lock, the result may be slightly behind.
+     * @return Counters summed over the shards.
+     */
+    UdpStats getStats() const;
+
+    static constexpr std::size_t MAX_IO_ENGINE_SHARDS = 16; /// shards receiving through the I/O engine
+
+    static constexpr const auto NAME = sstr::literal("UdpBorder");
+
+private:
+    /**
+     * Creates the receiver actors of the shards for the I/O engine.
+     */
+    template <std::size_t... indexes>
+    void newReceivers(std::index_sequence<indexes...>);
+
+    std::vector<std::unique_ptr<impl::UdpShard>> shards_;
+};
+
+} // namespace adst::ep::gw::udp
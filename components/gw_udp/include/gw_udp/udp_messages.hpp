@@ -0,0 +1,190 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/message.hpp"
+#include "gw_someip_codec/payload_codec.hpp"
+#include "gw_someip_codec/someip_codec.hpp"
+#include "gw_someip_codec/span.hpp"
+
+namespace adst::ep::gw::udp {
+
+/**
+ * IPv4 address and port, both in host byte order.
+ */
+struct UdpEndpoint
+{
+    std::uint32_t address_ = 0;
+    std::uint16_t port_    = 0;
+
+    static constexpr std::uint32_t LOOPBACK = 0x7f000001; /// 127.0.0.1
+
+    bool operator==(const UdpEndpoint& other) const
+    {
+        return address_ == other.address_ && port_ == other.port_;
+    }
+};
+
+/**
+ * A SOME/IP message received by a UdpBorder, together with the peer which sent it.
+ */
+struct ReceivedMessage
+{
+    UdpEndpoint         peer_;
+    someip::MessageView message_; /// view into the receive ring of the shard
+};
+
+namespace impl {
+
+/**
+ * One slot of the receive ring of a shard: the buffers recvmmsg fills and the messages decoded from
+ * them. A slot is busy while the SomeIpBatch published from it is alive.
+ */
+struct BatchSlot
+{
+    std::vector<std::uint8_t>    buffer_;              /// batchSize_ datagrams of maxDatagram_ bytes each
+    std::vector<ReceivedMessage> messages_;            /// decoded from buffer_, capacity kept across batches
+    std::size_t                  datagrams_ = 0;       /// datagrams received into buffer_
+    std::size_t                  malformed_ = 0;       /// datagrams not (completely) parsed as SOME/IP
+    std::atomic<bool>            busy_      = {false}; /// a published batch refers to the slot
+};
+
+} // namespace impl
+
+/**
+ * All SOME/IP messages a shard of a UdpBorder received in one wake-up, published as a single event.
+ *
+ * The messages are views into the receive ring of the shard, nothing is copied. The ring slot is
+ * reused when the last listener released the batch, so listeners shall copy what they keep. While all
+ * slots of a shard are held the shard stops reading its socket and the kernel buffers or drops.
+ */
+class SomeIpBatch
+{
+public:
+    // not copyable or movable
+    SomeIpBatch(const SomeIpBatch&) = delete;
+    SomeIpBatch(SomeIpBatch&&)      = delete;
+
+    SomeIpBatch& operator=(const SomeIpBatch&) = delete;
+    SomeIpBatch& operator=(SomeIpBatch&&) = delete;
+
+    /**
+     * @param slot The filled slot, marked busy by the shard. Shared, a batch still queued somewhere
+     *        may outlive the border.
+     * @param shard Index of the shard which received the batch.
+     */
+    SomeIpBatch(std::shared_ptr<impl::BatchSlot> slot, std::size_t shard)
+        : slot_(std::move(slot))
+        , shard_(shard)
+    {
+    }
+
+    ~SomeIpBatch()
+    {
+        slot_->busy_.store(false, std::memory_order_release);
+    }
+
+    const std::vector<ReceivedMessage>& getMessages() const
+    {
+        return slot_->messages_;
+    }
+
+    std::size_t getShard() const
+    {
+        return shard_;
+    }
+
+    std::size_t getDatagramCount() const
+    {
+        return slot_->datagrams_;
+    }
+
+    std::size_t getMalformedCount() const
+    {
+        return slot_->malformed_;
+    }
+
+    static constexpr const auto NAME = sstr::literal("SomeIpBatch");
+
+private:
+    const std::shared_ptr<impl::BatchSlot> slot_;
+    const std::size_t                      shard_;
+};
+
+/**
+ * Datagrams for a UdpBorder to send, each holding one SOME/IP message built in place. The border
+ * sends them with one sendmmsg call per batch size.
+ */
+class SomeIpSend
+{
+public:
+    // not copyable or movable
+    SomeIpSend(const SomeIpSend&) = delete;
+    SomeIpSend(SomeIpSend&&)      = delete;
+
+    SomeIpSend& operator=(const SomeIpSend&) = delete;
+    SomeIpSend& operator=(SomeIpSend&&) = delete;
+
+    /**
+     * @param shard The shard whose socket sends, all shards share the local port.
+     */
+    explicit SomeIpSend(std::size_t shard = 0)
+        : shard_(shard)
+    {
+    }
+
+    /**
+     * Position of one datagram in the bytes of the batch.
+     */
+    struct Datagram
+    {
+        UdpEndpoint peer_;
+        std::size_t offset_ = 0;
+        std::size_t size_   = 0;
+    };
+
+    /**
+     * Appends a datagram with one message.
+     * @param peer Where to send it.
+     * @param header The header of the message.
+     * @param payload The payload struct, see payload_codec.hpp.
+     */
+    template <typename T>
+    void add(const UdpEndpoint& peer, const someip::Header& header, const T& payload)
+    {
+        const auto offset = bytes_.size();
+        bytes_.resize(offset + someip::HEADER_SIZE + someip::serializedSize(payload));
+        const auto size = someip::buildMessage(someip::ByteSpan{bytes_.data() + offset, bytes_.size() - offset},
+                                               header, payload);
+        datagrams_.push_back({peer, offset, size});
+    }
+
+    const std::vector<std::uint8_t>& getBytes() const
+    {
+        return bytes_;
+    }
+
+    const std::vector<Datagram>& getDatagrams() const
+    {
+        return datagrams_;
+    }
+
+    std::size_t getShard() const
+    {
+        return shard_;
+    }
+
+    static constexpr const auto NAME = sstr::literal("SomeIpSend");
+
+private:
+    std::size_t               shard_;
+    std::vector<std::uint8_t> bytes_;
+    std::vector<Datagram>     datagrams_;
+};
+
+} // namespace adst::ep::gw::udp
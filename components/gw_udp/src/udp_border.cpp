@@ -0,0 +1,118 @@
+#include "gw_udp/udp_border.hpp"
+
+#include <fmt/format.h>
+
+#include "udp_shard.hpp"
+
+using Actor       = adst::ep::test_engine::core::Actor;
+using Environment = adst::ep::test_engine::core::Environment;
+using IoDatagrams = adst::ep::test_engine::core::IoDatagrams;
+using UdpBorder   = adst::ep::gw::udp::UdpBorder;
+using UdpSettings = adst::ep::gw::udp::UdpSettings;
+using UdpShard    = adst::ep::gw::udp::impl::UdpShard;
+using UdpStats    = adst::ep::gw::udp::UdpStats;
+using SomeIpBatch = adst::ep::gw::udp::SomeIpBatch;
+using SomeIpSend  = adst::ep::gw::udp::SomeIpSend;
+
+namespace {
+
+/**
+ * Receives the socket of one shard through the I/O engine of the dispatcher it is bound to. One type
+ * per shard, siblings of the same type would take each other's start.
+ */
+template <std::size_t index>
+class UdpShardReceiver : public Actor
+{
+public:
+    // not copyable or movable
+    UdpShardReceiver(const UdpShardReceiver&) = delete;
+    UdpShardReceiver(UdpShardReceiver&&)      = delete;
+
+    UdpShardReceiver& operator=(const UdpShardReceiver&) = delete;
+    UdpShardReceiver& operator=(UdpShardReceiver&&) = delete;
+
+    using SelfStartCnf = adst::ep::test_engine::core::StartCnf<UdpShardReceiver>;
+
+    UdpShardReceiver(const Environment& env, UdpShard& shard)
+        : Actor(NAME.c_str(), env)
+        , publish_([this](std::shared_ptr<SomeIpBatch> batch) { publish(std::move(batch)); })
+    {
+        pinToDispatcher(index);
+        // the shard is only used while started, stopping the receiver unregisters the socket
+        listen<SelfStartCnf>([this, &shard](const SelfStartCnf&) {
+            receive(shard.getSocket(),
+                    [this, &shard](const IoDatagrams& datagrams) { shard.deliver(datagrams, publish_); });
+        });
+    }
+    ~UdpShardReceiver() override = default;
+
+    static constexpr const auto NAME = sstr::literal("UdpShardReceiver");
+
+private:
+    const UdpShard::Publish publish_;
+};
+
+} // namespace
+
+UdpBorder::UdpBorder(const Environment& env, const UdpSettings& settings)
+    : Actor(NAME.c_str(), env)
+{
+    const auto& onError = env.configAndLogger_.config_.onErrorCallBack_;
+    if (settings.shards_ == 0) {
+        onError(adst::common::Error{{8, "UdpBorder: at least one shard is needed"}});
+    }
+    // the first shard resolves port 0, the others join its port
+    auto shared = settings;
+    for (std::size_t index = 0; index < settings.shards_; ++index) {
+        shards_.push_back(std::make_unique<UdpShard>(index, shared, onError));
+        shared.local_.port_ = shards_.front()->getLocalPort();
+    }
+
+    if (settings.ioEngine_) {
+        if (settings.shards_ > MAX_IO_ENGINE_SHARDS) {
+            onError(adst::common::Error{
+                {8, fmt::format("UdpBorder: at most {} shards with the I/O engine", MAX_IO_ENGINE_SHARDS)}});
+        }
+        newReceivers(std::make_index_sequence<MAX_IO_ENGINE_SHARDS>());
+    } else {
+        listen<test_engine::core::StartCnf<UdpBorder>>([this](const test_engine::core::StartCnf<UdpBorder>&) {
+            for (auto& shard : shards_) {
+                shard->start([this](std::shared_ptr<SomeIpBatch> batch) { publish(std::move(batch)); });
+            }
+        });
+        // the receive threads stop before the state leaves STARTED, so they never publish afterwards
+        listen<test_engine::core::StopCnf<UdpBorder>>([this](const test_engine::core::StopCnf<UdpBorder>&) {
+            for (auto& shard : shards_) {
+                shard->stop();
+            }
+        });
+    }
+    listen<SomeIpSend>([this](const SomeIpSend& send) { shards_[send.getShard() % shards_.size()]->send(send); });
+}
+
+template <std::size_t... indexes>
+void UdpBorder::newReceivers(std::index_sequence<indexes...>)
+{
+    ((indexes < shards_.size() ? (void)newChild<UdpShardReceiver<indexes>>(*shards_[indexes]) : void()), ...);
+}
+
+UdpBorder::~UdpBorder()
+{
+    for (auto& shard : shards_) {
+        shard->stop();
+    }
+}
+
+std::uint16_t UdpBorder::getLocalPort() const
+{
+    return shards_.front()->getLocalPort();
+}
+
+UdpStats UdpBorder::getStats() const
+{
+    UdpStats stats;
+    for (const auto& shard : shards_) {
+        shard->addStats(stats);
+    }
+    return stats;
+}
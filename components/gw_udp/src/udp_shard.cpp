@@ -0,0 +1,326 @@
+#include "udp_shard.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+using BatchSlot       = adst::ep::gw::udp::impl::BatchSlot;
+using Error           = adst::common::Error;
+using IoDatagrams     = adst::ep::test_engine::core::IoDatagrams;
+using OnErrorCallBack = adst::common::OnErrorCallBack;
+using MessageReader   = adst::ep::gw::someip::MessageReader;
+using MessageView     = adst::ep::gw::someip::MessageView;
+using ParseStatus     = adst::ep::gw::someip::ParseStatus;
+using SomeIpBatch     = adst::ep::gw::udp::SomeIpBatch;
+using SomeIpSend      = adst::ep::gw::udp::SomeIpSend;
+using UdpEndpoint     = adst::ep::gw::udp::UdpEndpoint;
+using UdpSettings     = adst::ep::gw::udp::UdpSettings;
+using UdpShard        = adst::ep::gw::udp::impl::UdpShard;
+using UdpStats        = adst::ep::gw::udp::UdpStats;
+
+namespace {
+
+constexpr auto RING_FULL_BACKOFF = std::chrono::microseconds{50}; /// sleep while all slots are held
+
+sockaddr_in toSockAddr(const UdpEndpoint& endpoint)
+{
+    sockaddr_in address     = {};
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(endpoint.address_);
+    address.sin_port        = htons(endpoint.port_);
+    return address;
+}
+
+UdpEndpoint toEndpoint(const sockaddr_in& address)
+{
+    return {ntohl(address.sin_addr.s_addr), ntohs(address.sin_port)};
+}
+
+} // namespace
+
+UdpShard::UdpShard(std::size_t index, const UdpSettings& settings, const OnErrorCallBack& onError)
+    : index_(index)
+    , settings_(settings)
+    , onError_(onError)
+    , receiveHeaders_(settings.batchSize_)
+    , receiveVectors_(settings.batchSize_)
+    , receivePeers_(settings.batchSize_)
+    , sendHeaders_(settings.batchSize_)
+    , sendVectors_(settings.batchSize_)
+    , sendPeers_(settings.batchSize_)
+{
+    if (settings_.batchSize_ == 0 || settings_.maxDatagram_ == 0 || settings_.ringDepth_ == 0) {
+        onError_(Error{{8, fmt::format("UdpShard {}: batch size, datagram size and ring depth shall be positive",
+                                       index_)}});
+    }
+    const auto fail = [this](const char* call) {
+        onError_(Error{{8, fmt::format("UdpShard {}: {} failed: {}", index_, call, std::strerror(errno))}});
+    };
+    socket_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (socket_ < 0) {
+        fail("socket");
+    }
+    const int enable = 1;
+    if (::setsockopt(socket_, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) != 0) {
+        fail("setsockopt(SO_REUSEPORT)");
+    }
+    if (settings_.receiveBufferSize_ > 0
+        && ::setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &settings_.receiveBufferSize_,
+                        sizeof(settings_.receiveBufferSize_))
+               != 0) {
+        fail("setsockopt(SO_RCVBUF)");
+    }
+    const auto local = toSockAddr(settings_.local_);
+    if (::bind(socket_, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0) { // NOLINT
+        fail("bind");
+    }
+    wakeUp_ = ::eventfd(0, EFD_CLOEXEC);
+    if (wakeUp_ < 0) {
+        fail("eventfd");
+    }
+
+    ring_.reserve(settings_.ringDepth_);
+    for (std::size_t slot = 0; slot < settings_.ringDepth_; ++slot) {
+        ring_.push_back(makeSlot());
+    }
+}
+
+std::shared_ptr<BatchSlot> UdpShard::makeSlot() const
+{
+    auto slot = std::make_shared<BatchSlot>();
+    slot->buffer_.resize(settings_.batchSize_ * settings_.maxDatagram_);
+    slot->messages_.reserve(settings_.batchSize_);
+    return slot;
+}
+
+UdpShard::~UdpShard()
+{
+    stop();
+    if (wakeUp_ >= 0) {
+        ::close(wakeUp_);
+    }
+    if (socket_ >= 0) {
+        ::close(socket_);
+    }
+}
+
+std::uint16_t UdpShard::getLocalPort() const
+{
+    sockaddr_in address = {};
+    socklen_t   length  = sizeof(address);
+    ::getsockname(socket_, reinterpret_cast<sockaddr*>(&address), &length); // NOLINT
+    return ntohs(address.sin_port);
+}
+
+int UdpShard::getSocket() const
+{
+    return socket_;
+}
+
+void UdpShard::start(Publish publish)
+{
+    publish_  = std::move(publish);
+    stopping_ = false;
+    thread_   = std::thread([this] { receiveLoop(); });
+}
+
+void UdpShard::stop()
+{
+    if (!thread_.joinable()) {
+        return;
+    }
+    stopping_ = true;
+    const std::uint64_t one = 1;
+    if (::write(wakeUp_, &one, sizeof(one)) != sizeof(one)) {
+        onError_(Error{{8, fmt::format("UdpShard {}: wake-up failed: {}", index_, std::strerror(errno))}});
+    }
+    thread_.join();
+}
+
+void UdpShard::receiveLoop()
+{
+    // the kernel limits thread names to 15 characters
+    pthread_setname_np(pthread_self(), fmt::format("udp-rx-{}", index_).substr(0, 15).c_str());
+    std::array<pollfd, 2> fds = {pollfd{socket_, POLLIN, 0}, pollfd{wakeUp_, POLLIN, 0}};
+    while (!stopping_) {
+        if (::poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            onError_(Error{{8, fmt::format("UdpShard {}: poll failed: {}", index_, std::strerror(errno))}});
+            return;
+        }
+        if (fds[1].revents != 0 || !receiveBatches()) {
+            return;
+        }
+    }
+}
+
+bool UdpShard::receiveBatches()
+{
+    for (;;) {
+        const auto* ringSlot = takeSlot();
+        if (ringSlot == nullptr) {
+            return false;
+        }
+        auto& slot = **ringSlot;
+        for (std::size_t index = 0; index < settings_.batchSize_; ++index) {
+            receiveVectors_[index] = {slot.buffer_.data() + index * settings_.maxDatagram_, settings_.maxDatagram_};
+            auto& header           = receiveHeaders_[index].msg_hdr;
+            header                 = {};
+            header.msg_name        = &receivePeers_[index];
+            header.msg_namelen     = sizeof(sockaddr_in);
+            header.msg_iov         = &receiveVectors_[index];
+            header.msg_iovlen      = 1;
+        }
+        const int count = ::recvmmsg(socket_, receiveHeaders_.data(), static_cast<unsigned>(settings_.batchSize_),
+                                     MSG_DONTWAIT, nullptr);
+        if (count <= 0) {
+            if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                onError_(Error{{8, fmt::format("UdpShard {}: recvmmsg failed: {}", index_, std::strerror(errno))}});
+            }
+            return true; // drained, back to poll
+        }
+        decode(slot, static_cast<std::size_t>(count));
+        publishSlot(*ringSlot, publish_);
+        if (static_cast<std::size_t>(count) < settings_.batchSize_) {
+            return true; // the socket is most likely empty, poll instead of another empty recvmmsg
+        }
+    }
+}
+
+const std::shared_ptr<BatchSlot>* UdpShard::takeSlot()
+{
+    auto& slot    = *ring_[nextSlot_];
+    bool  counted = false;
+    while (slot.busy_.load(std::memory_order_acquire)) {
+        if (stopping_) {
+            return nullptr;
+        }
+        if (!counted) {
+            ringFull_.fetch_add(1, std::memory_order_relaxed);
+            counted = true;
+        }
+        std::this_thread::sleep_for(RING_FULL_BACKOFF);
+    }
+    return &ring_[nextSlot_];
+}
+
+void UdpShard::deliver(const IoDatagrams& datagrams, const Publish& publish)
+{
+    for (std::size_t first = 0; first < datagrams.size(); first += settings_.batchSize_) {
+        auto& ringSlot = ring_[nextSlot_];
+        if (ringSlot->busy_.load(std::memory_order_acquire)) {
+            // the batch holding it keeps the old slot alive
+            ringFull_.fetch_add(1, std::memory_order_relaxed);
+            ringSlot = makeSlot();
+        }
+        auto&      slot  = *ringSlot;
+        const auto count = std::min(settings_.batchSize_, datagrams.size() - first);
+        slot.messages_.clear();
+        slot.datagrams_ = count;
+        slot.malformed_ = 0;
+        for (std::size_t index = 0; index < count; ++index) {
+            const auto& datagram = datagrams[first + index];
+            const auto  size     = std::min(datagram.size_, settings_.maxDatagram_);
+            std::memcpy(slot.buffer_.data() + index * settings_.maxDatagram_, datagram.data_, size);
+            decodeDatagram(slot, {datagram.peerAddress_, datagram.peerPort_}, index, size,
+                           datagram.truncated_ || datagram.size_ > settings_.maxDatagram_);
+        }
+        datagrams_.fetch_add(count, std::memory_order_relaxed);
+        malformed_.fetch_add(slot.malformed_, std::memory_order_relaxed);
+        publishSlot(ringSlot, publish);
+    }
+}
+
+void UdpShard::decode(BatchSlot& slot, std::size_t count)
+{
+    slot.messages_.clear();
+    slot.datagrams_ = count;
+    slot.malformed_ = 0;
+    for (std::size_t index = 0; index < count; ++index) {
+        const auto& header = receiveHeaders_[index];
+        decodeDatagram(slot, toEndpoint(receivePeers_[index]), index, header.msg_len,
+                       (header.msg_hdr.msg_flags & MSG_TRUNC) != 0);
+    }
+    datagrams_.fetch_add(count, std::memory_order_relaxed);
+    malformed_.fetch_add(slot.malformed_, std::memory_order_relaxed);
+}
+
+void UdpShard::decodeDatagram(BatchSlot& slot, const UdpEndpoint& peer, std::size_t index, std::size_t size,
+                              bool truncated)
+{
+    if (truncated) {
+        ++slot.malformed_;
+        return;
+    }
+    MessageReader reader({slot.buffer_.data() + index * settings_.maxDatagram_, size});
+    MessageView   message;
+    while (reader.next(message)) {
+        slot.messages_.push_back({peer, message});
+    }
+    if (reader.status() != ParseStatus::OK) {
+        ++slot.malformed_;
+    }
+}
+
+void UdpShard::publishSlot(const std::shared_ptr<BatchSlot>& slot, const Publish& publish)
+{
+    slot->busy_.store(true, std::memory_order_relaxed);
+    nextSlot_ = (nextSlot_ + 1) % ring_.size();
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    publish(test_engine::core::Actor::make<SomeIpBatch>(slot, index_));
+}
+
+void UdpShard::send(const SomeIpSend& send)
+{
+    const auto& datagrams = send.getDatagrams();
+    // sendmmsg takes non-const buffers, it does not write them
+    auto* bytes = const_cast<std::uint8_t*>(send.getBytes().data()); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    for (std::size_t first = 0; first < datagrams.size();) {
+        const auto count = std::min(settings_.batchSize_, datagrams.size() - first);
+        for (std::size_t index = 0; index < count; ++index) {
+            const auto& datagram   = datagrams[first + index];
+            sendPeers_[index]      = toSockAddr(datagram.peer_);
+            sendVectors_[index]    = {bytes + datagram.offset_, datagram.size_};
+            auto& header           = sendHeaders_[index].msg_hdr;
+            header                 = {};
+            header.msg_name        = &sendPeers_[index];
+            header.msg_namelen     = sizeof(sockaddr_in);
+            header.msg_iov         = &sendVectors_[index];
+            header.msg_iovlen      = 1;
+        }
+        const int result = ::sendmmsg(socket_, sendHeaders_.data(), static_cast<unsigned>(count), MSG_DONTWAIT);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // EAGAIN: the socket buffer is full, the datagram is dropped like the network would
+            sendDropped_.fetch_add(1, std::memory_order_relaxed);
+            ++first;
+            continue;
+        }
+        sent_.fetch_add(static_cast<std::uint64_t>(result), std::memory_order_relaxed);
+        first += static_cast<std::size_t>(result);
+    }
+}
+
+void UdpShard::addStats(UdpStats& stats) const
+{
+    stats.batches_ += batches_.load(std::memory_order_relaxed);
+    stats.datagrams_ += datagrams_.load(std::memory_order_relaxed);
+    stats.malformed_ += malformed_.load(std::memory_order_relaxed);
+    stats.ringFull_ += ringFull_.load(std::memory_order_relaxed);
+    stats.sent_ += sent_.load(std::memory_order_relaxed);
+    stats.sendDropped_ += sendDropped_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "adstutil_cxx/error_handler.hpp"
+#include "core/core_types.hpp"
+#include "gw_udp/udp_border.hpp"
+#include "gw_udp/udp_messages.hpp"
+
+namespace adst::ep::gw::udp::impl {
+
+/**
+ * One socket of a UdpBorder with its receive thread and receive ring. The receive side is only
+ * touched by the receive thread (or, with an I/O engine, the actor receiving the socket), the send
+ * side only by the dispatcher running the border.
+ */
+class UdpShard
+{
+public:
+    using Publish = std::function<void(std::shared_ptr<SomeIpBatch>)>;
+
+    // not copyable or movable
+    UdpShard(const UdpShard&) = delete;
+    UdpShard(UdpShard&&)      = delete;
+
+    UdpShard& operator=(const UdpShard&) = delete;
+    UdpShard& operator=(UdpShard&&) = delete;
+
+    /**
+     * Opens and binds the socket, errors are reported to onError.
+     * @param index Index of the shard, set in the published batches.
+     * @param settings Settings of the border, local_.port_ shall be the port all shards share.
+     * @param onError The error callback of the config.
+     */
+    UdpShard(std::size_t index, const UdpSettings& settings, const adst::common::OnErrorCallBack& onError);
+    ~UdpShard();
+
+    /**
+     * @return The port the socket is bound to.
+     */
+    std::uint16_t getLocalPort() const;
+
+    /**
+     * @return The socket, for receiving through an I/O engine instead of start().
+     */
+    int getSocket() const;
+
+    /**
+     * Starts the receive thread.
+     * @param publish Publishes a batch on the network, called by the receive thread.
+     */
+    void start(Publish publish);
+
+    /**
+     * Wakes the receive thread and waits till it finished, no batch is published afterwards.
+     */
+    void stop();
+
+    /**
+     * Copies datagrams an I/O engine received from the socket into the ring and publishes them,
+     * batchSize_ at a time. A slot still held is replaced by a new one, the caller shall not block.
+     * @param datagrams The datagrams, in the buffers of the engine.
+     * @param publish Publishes a batch on the network.
+     */
+    void deliver(const test_engine::core::IoDatagrams& datagrams, const Publish& publish);
+
+    /**
+     * Sends the datagrams of the batch, batchSize_ at a time.
+     * @param send The datagrams.
+     */
+    void send(const SomeIpSend& send);
+
+    /**
+     * @param stats Adds the counters of the shard.
+     */
+    void addStats(UdpStats& stats) const;
+
+private:
+    void receiveLoop();
+
+    /**
+     * Drains the socket into free slots of the ring and publishes a batch per recvmmsg call.
+     * @return False if the shard is stopping.
+     */
+    bool receiveBatches();
+
+    /**
+     * @return The next slot of the ring after it was released, nullptr if the shard is stopping.
+     */
+    const std::shared_ptr<BatchSlot>* takeSlot();
+
+    /**
+     * @return A slot with the buffers of the settings.
+     */
+    std::shared_ptr<BatchSlot> makeSlot() const;
+
+    /**
+     * Parses the datagrams of the slot into its messages.
+     * @param slot The slot, filled by recvmmsg.
+     * @param count Number of datagrams received.
+     */
+    void decode(BatchSlot& slot, std::size_t count);
+
+    /**
+     * Parses one datagram of the slot, counts it as malformed if it is truncated or not SOME/IP.
+     * @param slot The slot, messages_ and malformed_ are updated.
+     * @param peer The sender.
+     * @param index Position of the datagram in the buffer of the slot.
+     * @param size Bytes received.
+     * @param truncated The datagram did not fit.
+     */
+    void decodeDatagram(BatchSlot& slot, const UdpEndpoint& peer, std::size_t index, std::size_t size,
+                        bool truncated);
+
+    /**
+     * Publishes the decoded slot and moves on to the next one.
+     */
+    void publishSlot(const std::shared_ptr<BatchSlot>& slot, const Publish& publish);
+
+    const std::size_t                       index_;
+    const UdpSettings                       settings_;
+    const adst::common::OnErrorCallBack&    onError_;
+    int                                     socket_ = -1; /// the UDP socket
+    int                                     wakeUp_ = -1; /// eventfd waking the receive thread to stop
+    Publish                                 publish_;
+    std::thread                             thread_;
+    std::atomic<bool>                       stopping_ = {false};
+    std::vector<std::shared_ptr<BatchSlot>> ring_;
+    std::size_t                             nextSlot_ = 0;
+
+    // recvmmsg arguments, point into the slot being filled
+    std::vector<mmsghdr>     receiveHeaders_;
+    std::vector<iovec>       receiveVectors_;
+    std::vector<sockaddr_in> receivePeers_;
+
+    // sendmmsg arguments, point into the SomeIpSend being sent
+    std::vector<mmsghdr>     sendHeaders_;
+    std::vector<iovec>       sendVectors_;
+    std::vector<sockaddr_in> sendPeers_;
+
+    std::atomic<std::uint64_t> batches_     = {0};
+    std::atomic<std::uint64_t> datagrams_   = {0};
+    std::atomic<std::uint64_t> malformed_   = {0};
+    std::atomic<std::uint64_t> ringFull_    = {0};
+    std::atomic<std::uint64_t> sent_        = {0};
+    std::atomic<std::uint64_t> sendDropped_ = {0};
+};
+
+} // namespace adst::ep::gw::udp::impl
@@ -0,0 +1,243 @@
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "config_cxx/config_and_logger.hpp"
+#include "core/core.hpp"
+#include "gw_someip_codec/payload_codec.hpp"
+#include "gw_someip_codec/someip_codec.hpp"
+#include "gw_udp/udp_border.hpp"
+
+using adst::common::Config;
+using adst::common::ConfigAndLogger;
+using adst::common::Error;
+using adst::ep::gw::someip::ByteSpan;
+using adst::ep::gw::someip::Header;
+using adst::ep::gw::someip::MessageType;
+using adst::ep::gw::someip::MessageView;
+using adst::ep::gw::someip::parse;
+using adst::ep::gw::someip::ParseStatus;
+using adst::ep::gw::someip::writeHeader;
+using adst::ep::gw::udp::SomeIpBatch;
+using adst::ep::gw::udp::SomeIpSend;
+using adst::ep::gw::udp::UdpBorder;
+using adst::ep::gw::udp::UdpEndpoint;
+using adst::ep::gw::udp::UdpSettings;
+using adst::ep::gw::udp::UdpStats;
+using adst::ep::test_engine::core::Actor;
+using adst::ep::test_engine::core::Core;
+using adst::ep::test_engine::core::Environment;
+using adst::ep::test_engine::core::StartCnf;
+using adst::ep::test_engine::core::Stop;
+
+namespace {
+
+constexpr int           DISPATCHER_COUNT = 2;
+constexpr int           PEER_COUNT       = 4;  /// stand-in peers, each with its own source port
+constexpr int           DATAGRAM_COUNT   = 50; /// datagrams sent by each peer
+constexpr std::uint16_t SERVICE          = 0x1234;
+
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const adst::common::OnErrorCallBack onError = [](const Error& error) {
+    std::cerr << error.errorCodeName_.second << std::endl;
+    GTEST_FAIL();
+};
+
+/**
+ * Stand-in for a remote SOME/IP node: a plain UDP socket on loopback.
+ */
+class Peer
+{
+public:
+    Peer(const Peer&) = delete;
+    Peer& operator=(const Peer&) = delete;
+    Peer(Peer&&)                 = delete;
+    Peer& operator=(Peer&&) = delete;
+
+    Peer()
+        : socket_(::socket(AF_INET, SOCK_DGRAM, 0))
+    {
+        sockaddr_in address     = {};
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = htonl(UdpEndpoint::LOOPBACK);
+        ::bind(socket_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)); // NOLINT
+        socklen_t length = sizeof(address);
+        ::getsockname(socket_, reinterpret_cast<sockaddr*>(&address), &length); // NOLINT
+        endpoint_ = {UdpEndpoint::LOOPBACK, ntohs(address.sin_port)};
+        timeval timeout = {1, 0};
+        ::setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    ~Peer()
+    {
+        ::close(socket_);
+    }
+
+    /**
+     * Sends one datagram with two messages back to back, the session ids are 2 * session and
+     * 2 * session + 1.
+     */
+    void sendPair(std::uint16_t port, std::uint16_t session) const
+    {
+        std::array<std::uint8_t, 2 * adst::ep::gw::someip::HEADER_SIZE> datagram = {};
+        for (std::uint16_t index = 0; index < 2; ++index) {
+            Header header       = {SERVICE, 1, endpoint_.port_, static_cast<std::uint16_t>(2 * session + index)};
+            header.messageType_ = MessageType::REQUEST_NO_RETURN;
+            writeHeader(ByteSpan{datagram.data() + index * adst::ep::gw::someip::HEADER_SIZE,
+                                 adst::ep::gw::someip::HEADER_SIZE},
+                        header, 0);
+        }
+        sendRaw(port, datagram.data(), datagram.size());
+    }
+
+    void sendRaw(std::uint16_t port, const std::uint8_t* bytes, std::size_t size) const
+    {
+        sockaddr_in address     = {};
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = htonl(UdpEndpoint::LOOPBACK);
+        address.sin_port        = htons(port);
+        ::sendto(socket_, bytes, size, 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address)); // NOLINT
+    }
+
+    /**
+     * @return The session ids of the replies, waits up to a second for each.
+     */
+    std::vector<std::uint16_t> receiveReplies(std::size_t count) const
+    {
+        std::vector<std::uint16_t>   sessions;
+        std::array<std::uint8_t, 64> buffer = {};
+        while (sessions.size() < count) {
+            const auto size = ::recv(socket_, buffer.data(), buffer.size(), 0);
+            if (size <= 0) {
+                break;
+            }
+            MessageView message;
+            if (parse({buffer.data(), static_cast<std::size_t>(size)}, message) == ParseStatus::OK) {
+                sessions.push_back(message.sessionId());
+            }
+        }
+        return sessions;
+    }
+
+private:
+    int         socket_;
+    UdpEndpoint endpoint_;
+};
+
+/**
+ * Starts the peers sending once the border is up, answers each received message and stops the core
+ * when all of them arrived.
+ */
+struct UdpTestRoot : public Actor
+{
+    // not copiable or movable
+    UdpTestRoot(const UdpTestRoot&) = delete;
+    UdpTestRoot& operator=(const UdpTestRoot&) = delete;
+    UdpTestRoot(UdpTestRoot&&)                 = delete;
+    UdpTestRoot& operator=(UdpTestRoot&&) = delete;
+
+    using SelfStartCnf = StartCnf<UdpTestRoot>;
+
+    UdpTestRoot(const Environment& env, const UdpSettings& settings, const std::vector<std::unique_ptr<Peer>>& peers,
+                UdpStats& stats)
+        : Actor(NAME.c_str(), env)
+    {
+        const auto border = newChild<UdpBorder>(settings);
+        const auto port   = static_cast<const UdpBorder&>(getChild(border)).getLocalPort();
+        listen<SelfStartCnf>([&peers, port](const SelfStartCnf&) {
+            const std::uint8_t garbage = 0;
+            peers.front()->sendRaw(port, &garbage, 1);
+            for (std::uint16_t session = 0; session < DATAGRAM_COUNT; ++session) {
+                for (const auto& peer : peers) {
+                    peer->sendPair(port, session);
+                }
+            }
+        });
+        listen<SomeIpBatch>([this, border, &stats, &peers](const SomeIpBatch& batch) {
+            auto reply = std::make_unique<SomeIpSend>(batch.getShard());
+            for (const auto& received : batch.getMessages()) {
+                Header header       = received.message_.header();
+                header.messageType_ = MessageType::RESPONSE;
+                reply->add(received.peer_, header, std::uint8_t{0});
+            }
+            received_ += batch.getMessages().size();
+            publish(std::move(reply));
+            if (received_ == 2U * DATAGRAM_COUNT * peers.size()) {
+                stats = static_cast<const UdpBorder&>(getChild(border)).getStats();
+                publish(std::make_unique<Stop>());
+            }
+        });
+    }
+    ~UdpTestRoot() override = default;
+
+    std::size_t received_ = 0;
+
+    static constexpr const auto NAME = sstr::literal("UdpTestRoot");
+};
+
+/**
+ * Runs 50 datagrams of each peer through a border of two shards and checks the replies.
+ * @param doc Config of the core.
+ */
+void checkRoundTrip(bool ioEngine, const std::string& doc)
+{
+    std::vector<std::unique_ptr<Peer>> peers;
+    for (int peer = 0; peer < PEER_COUNT; ++peer) {
+        peers.push_back(std::make_unique<Peer>());
+    }
+    UdpSettings settings;
+    settings.local_             = {UdpEndpoint::LOOPBACK, 0};
+    settings.shards_            = 2;
+    settings.batchSize_         = 8;
+    settings.ringDepth_         = 4;
+    settings.receiveBufferSize_ = 1 << 20;
+    settings.ioEngine_          = ioEngine;
+    UdpStats stats;
+    {
+        ConfigAndLogger confLog = {Config{onError, DISPATCHER_COUNT, "", doc}};
+        Core            core(confLog);
+        core.init<UdpTestRoot>(settings, peers, stats);
+        core.run();
+    }
+
+    EXPECT_EQ(stats.datagrams_, 1U + DATAGRAM_COUNT * PEER_COUNT);
+    EXPECT_EQ(stats.malformed_, 1U);
+    EXPECT_LE(stats.batches_, stats.datagrams_);
+    for (const auto& peer : peers) {
+        const auto sessions = peer->receiveReplies(2 * DATAGRAM_COUNT);
+        ASSERT_EQ(sessions.size(), 2U * DATAGRAM_COUNT);
+        for (std::uint16_t session = 0; session < 2 * DATAGRAM_COUNT; ++session) {
+            EXPECT_EQ(sessions[session], session); // one peer is served by one shard, in order
+        }
+    }
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UdpBorderTest, LoopbackRoundTrip)
+{
+    checkRoundTrip(false, Config::DEFAULT_CONFIG.c_str());
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UdpBorderTest, LoopbackRoundTripIoEngine)
+{
+    for (const std::string backend : {"epoll", "uring"}) {
+        SCOPED_TRACE(backend);
+        checkRoundTrip(true, "dispatchers:\n"
+                             "  normal:\n"
+                             "    io: "
+                                 + backend + "\n");
+    }
+}
@@ -0,0 +1,576 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "adstutil_cxx/static_string.hpp"
+#include "bench_util.hpp"
+#include "config_cxx/config_and_logger.hpp"
+#include "core/core.hpp"
+
+using adst::common::Config;
+using adst::common::ConfigAndLogger;
+using adst::common::Error;
+using adst::ep::test_engine::core::Actor;
+using adst::ep::test_engine::core::CallBackHandle;
+using adst::ep::test_engine::core::Core;
+using adst::ep::test_engine::core::Environment;
+using adst::ep::test_engine::core::StartCnf;
+using adst::ep::test_engine::core::Stop;
+using adst::ep::test_engine::core::bench::elapsedNs;
+using adst::ep::test_engine::core::bench::maxDispatchers;
+using adst::ep::test_engine::core::bench::reportLatencies;
+
+namespace sstr = ak_toolkit::static_str;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int ROUND_TRIPS   = 2000; /// ping-pong round trips in one run of the core
+constexpr int FAN_ROUNDS    = 500;  /// messages published to all receivers in one run of the core
+constexpr int MAX_FAN       = 16;   /// most receivers of the fan-out and senders of the fan-in
+constexpr int FAN_IN_BURST  = 64;   /// messages each sender publishes in one fan-in round
+constexpr int FAN_IN_ROUNDS = 20;   /// fan-in rounds in one run of the core
+constexpr int CHURN_ROUNDS  = 2000; /// listen, deliver, unlisten cycles in one run of the core
+
+constexpr int         AFFINITY_ROUNDS = 500;  /// messages published to all bridges in one run of the core
+constexpr std::size_t BRIDGE_STATE    = 4096; /// words of state a bridge walks per message, 32 KiB
+
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const adst::common::OnErrorCallBack onError = [](const Error& error) {
+    std::cerr << error.errorCodeName_.second << std::endl;
+    exit(1);
+};
+
+/**
+ * One logger per dispatcher count, the benchmark library runs each case several times.
+ */
+const ConfigAndLogger& getConfigAndLogger(int dispatchers)
+{
+    static std::map<int, std::unique_ptr<ConfigAndLogger>> confLogs;
+    auto&                                                  confLog = confLogs[dispatchers];
+    if (!confLog) {
+        confLog.reset(new ConfigAndLogger{Config{onError, dispatchers}}); // NOLINT(cppcoreguidelines-owning-memory)
+    }
+    return *confLog;
+}
+
+std::vector<std::int64_t> latencies; /// latencies in ns of all runs of a benchmark, written by the root
+
+/// latencies in ns per receiver of the fan-out, each only written by its receiver
+std::array<std::vector<std::int64_t>, MAX_FAN> receiverLatencies;
+
+/**
+ * Runs a core with the given root per iteration of the benchmark. The latencies of all iterations are
+ * reported as percentiles.
+ * @tparam TRoot The root actor.
+ * @param state The running benchmark, range(0) is the dispatcher count.
+ * @param args Constructor arguments of the root.
+ */
+template <typename TRoot, typename... Args>
+void runCore(benchmark::State& state, Args... args)
+{
+    const auto& confLog = getConfigAndLogger(static_cast<int>(state.range(0)));
+    latencies.clear();
+    for (auto _ : state) {
+        Core core(confLog);
+        core.init<TRoot>(args...);
+        core.run();
+    }
+    for (auto& receiver : receiverLatencies) {
+        latencies.insert(latencies.end(), receiver.begin(), receiver.end());
+        receiver.clear();
+    }
+    reportLatencies(state, latencies);
+}
+
+/**
+ * Carries its send time, so the receiver can measure the latency.
+ */
+struct Timed
+{
+    explicit Timed(Clock::time_point sent = Clock::now())
+        : sent_(sent)
+    {
+    }
+    Clock::time_point sent_;
+};
+
+struct Ping final : public Timed /// ping-pong request
+{
+    using Timed::Timed;
+    static constexpr auto NAME = sstr::literal("Ping");
+};
+
+struct Pong final : public Timed /// ping-pong reply, carries the send time of the ping
+{
+    using Timed::Timed;
+    static constexpr auto NAME = sstr::literal("Pong");
+};
+
+struct Tick final : public Timed /// published to all fan-out receivers
+{
+    using Timed::Timed;
+    static constexpr auto NAME = sstr::literal("Tick");
+};
+
+struct Ack final : public Timed /// reply of a fan-out receiver
+{
+    using Timed::Timed;
+    static constexpr auto NAME = sstr::literal("Ack");
+};
+
+struct Go final : public Timed /// starts a fan-in round
+{
+    using Timed::Timed;
+    static constexpr auto NAME = sstr::literal("Go");
+};
+
+struct Data final : public Timed /// published by the fan-in senders
+{
+    using Timed::Timed;
+    static constexpr auto NAME = sstr::literal("Data");
+};
+
+struct Poke final : public Timed /// published to the listen of the churn
+{
+    using Timed::Timed;
+    static constexpr auto NAME = sstr::literal("Poke");
+};
+
+/**
+ * Answers each ping.
+ */
+struct PongActor : public Actor
+{
+    // not copyable or movable
+    PongActor(const PongActor&) = delete;
+    PongActor(PongActor&&)      = delete;
+
+    PongActor& operator=(const PongActor&) = delete;
+    PongActor& operator=(PongActor&&) = delete;
+
+    explicit PongActor(const Environment& env)
+        : Actor(NAME.c_str(), env)
+    {
+        listen<Ping>([this](const Ping& ping) { publish(std::make_unique<Pong>(ping.sent_)); });
+    }
+    ~PongActor() override = default;
+
+    static constexpr const auto NAME = sstr::literal("PongActor");
+};
+
+/**
+ * Sends a ping after the pong of the previous one, the latency is the round trip.
+ */
+struct PingPongRoot : public Actor
+{
+    // not copyable or movable
+    PingPongRoot(const PingPongRoot&) = delete;
+    PingPongRoot(PingPongRoot&&)      = delete;
+
+    PingPongRoot& operator=(const PingPongRoot&) = delete;
+    PingPongRoot& operator=(PingPongRoot&&) = delete;
+
+    using SelfStartCnf = StartCnf<PingPongRoot>;
+
+    explicit PingPongRoot(const Environment& env)
+        : Actor(NAME.c_str(), env)
+    {
+        listen<SelfStartCnf>([this](const SelfStartCnf&) { publish(std::make_unique<Ping>()); });
+        listen<Pong>([this](const Pong& pong) {
+            latencies.push_back(elapsedNs(pong.sent_));
+            if (++roundTrips_ < ROUND_TRIPS) {
+                publish(std::make_unique<Ping>());
+            } else {
+                publish(std::make_unique<Stop>());
+            }
+        });
+        newChild<PongActor>();
+    }
+    ~PingPongRoot() override = default;
+
+    int roundTrips_ = 0; /// pongs received
+
+    static constexpr const auto NAME = sstr::literal("PingPongRoot");
+};
+
+/**
+ * One of the fan-out receivers, each has its own type, children of the same type can not be told
+ * apart by the life cycle.
+ */
+template <int number>
+struct TickReceiver : public Actor
+{
+    // not copyable or movable
+    TickReceiver(const TickReceiver&) = delete;
+    TickReceiver(TickReceiver&&)      = delete;
+
+    TickReceiver& operator=(const TickReceiver&) = delete;
+    TickReceiver& operator=(TickReceiver&&) = delete;
+
+    explicit TickReceiver(const Environment& env)
+        : Actor(NAME.c_str(), env)
+    {
+        listen<Tick>([this](const Tick& tick) {
+            receiverLatencies[number].push_back(elapsedNs(tick.sent_));
+            publish(std::make_unique<Ack>());
+        });
+    }
+    ~TickReceiver() override = default;
+
+    static constexpr const auto NAME = sstr::literal("TickReceiver");
+};
+
+/**
+ * Publishes a tick to all receivers when all of them acknowledged the previous one. The latency is
+ * the time from the publish till a receiver gets the tick.
+ */
+struct FanOutRoot : public Actor
+{
+    // not copyable or movable
+    FanOutRoot(const FanOutRoot&) = delete;
+    FanOutRoot(FanOutRoot&&)      = delete;
+
+    FanOutRoot& operator=(const FanOutRoot&) = delete;
+    FanOutRoot& operator=(FanOutRoot&&) = delete;
+
+    using SelfStartCnf = StartCnf<FanOutRoot>;
+
+    FanOutRoot(const Environment& env, int receivers)
+        : Actor(NAME.c_str(), env)
+        , receivers_(receivers)
+    {
+        listen<SelfStartCnf>([this](const SelfStartCnf&) { publish(std::make_unique<Tick>()); });
+        listen<Ack>([this](const Ack&) {
+            if (++acks_ < receivers_) {
+                return;
+            }
+            acks_ = 0;
+            if (++rounds_ < FAN_ROUNDS) {
+                publish(std::make_unique<Tick>());
+            } else {
+                publish(std::make_unique<Stop>());
+            }
+        });
+        newReceivers(std::make_integer_sequence<int, MAX_FAN>());
+    }
+    ~FanOutRoot() override = default;
+
+    template <int... numbers>
+    void newReceivers(std::integer_sequence<int, numbers...>)
+    {
+        ((numbers < receivers_ ? (void)newChild<TickReceiver<numbers>>() : void()), ...);
+    }
+
+    const int receivers_;  /// number of receivers
+    int       acks_   = 0; /// acknowledges of the current tick
+    int       rounds_ = 0; /// ticks acknowledged by all receivers
+
+    static constexpr const auto NAME = sstr::literal("FanOutRoot");
+};
+
+/**
+ * One of the fan-in senders, publishes a burst of data on each go.
+ */
+template <int number>
+struct DataSender : public Actor
+{
+    // not copyable or movable
+    DataSender(const DataSender&) = delete;
+    DataSender(DataSender&&)      = delete;
+
+    DataSender& operator=(const DataSender&) = delete;
+    DataSender& operator=(DataSender&&) = delete;
+
+    explicit DataSender(const Environment& env)
+        : Actor(NAME.c_str(), env)
+    {
+        listen<Go>([this](const Go&) {
+            for (int message = 0; message < FAN_IN_BURST; ++message) {
+                publish(std::make_unique<Data>());
+            }
+        });
+    }
+    ~DataSender() override = default;
+
+    static constexpr const auto NAME = sstr::literal("DataSender");
+};
+
+/**
+ * Receives the data of all senders, starts the next round when the bursts of all senders arrived.
+ * The latency is the time from the publish of the data till the root gets it.
+ */
+struct FanInRoot : public Actor
+{
+    // not copyable or movable
+    FanInRoot(const FanInRoot&) = delete;
+    FanInRoot(FanInRoot&&)      = delete;
+
+    FanInRoot& operator=(const FanInRoot&) = delete;
+    FanInRoot& operator=(FanInRoot&&) = delete;
+
+    using SelfStartCnf = StartCnf<FanInRoot>;
+
+    FanInRoot(const Environment& env, int senders)
+        : Actor(NAME.c_str(), env)
+        , senders_(senders)
+    {
+        listen<SelfStartCnf>([this](const SelfStartCnf&) { publish(std::make_unique<Go>()); });
+        listen<Data>([this](const Data& data) {
+            latencies.push_back(elapsedNs(data.sent_));
+            if (++received_ < senders_ * FAN_IN_BURST) {
+                return;
+            }
+            received_ = 0;
+            if (++rounds_ < FAN_IN_ROUNDS) {
+                publish(std::make_unique<Go>());
+            } else {
+                publish(std::make_unique<Stop>());
+            }
+        });
+        newSenders(std::make_integer_sequence<int, MAX_FAN>());
+    }
+    ~FanInRoot() override = default;
+
+    template <int... numbers>
+    void newSenders(std::integer_sequence<int, numbers...>)
+    {
+        ((numbers < senders_ ? (void)newChild<DataSender<numbers>>() : void()), ...);
+    }
+
+    const int senders_;      /// number of senders
+    int       received_ = 0; /// data received in the current round
+    int       rounds_   = 0; /// rounds finished
+
+    static constexpr const auto NAME = sstr::literal("FanInRoot");
+};
+
+/**
+ * Stateful actor walking its whole state on each tick, like a bridge updating its tables. Pinned
+ * bridges are bound to the dispatcher of their number.
+ */
+template <int number>
+struct StatefulBridge : public Actor
+{
+    // not copyable or movable
+    StatefulBridge(const StatefulBridge&) = delete;
+    StatefulBridge(StatefulBridge&&)      = delete;
+
+    StatefulBridge& operator=(const StatefulBridge&) = delete;
+    StatefulBridge& operator=(StatefulBridge&&) = delete;
+
+    StatefulBridge(const Environment& env, bool pinned)
+        : Actor(NAME.c_str(), env)
+        , state_(BRIDGE_STATE, number)
+    {
+        if (pinned) {
+            pinToDispatcher(number);
+        }
+        listen<Tick>([this](const Tick&) {
+            std::uint64_t sum = 0;
+            for (auto& word : state_) {
+                sum += word;
+                word = sum;
+            }
+            benchmark::DoNotOptimize(sum);
+            publish(std::make_unique<Ack>());
+        });
+    }
+    ~StatefulBridge() override = default;
+
+    std::vector<std::uint64_t> state_; /// the tables of the bridge
+
+    static constexpr const auto NAME = sstr::literal("StatefulBridge");
+};
+
+/**
+ * Publishes a tick to all bridges when all of them acknowledged the previous one. The latency is the
+ * time till all bridges acknowledged a tick.
+ */
+struct AffinityRoot : public Actor
+{
+    // not copyable or movable
+    AffinityRoot(const AffinityRoot&) = delete;
+    AffinityRoot(AffinityRoot&&)      = delete;
+
+    AffinityRoot& operator=(const AffinityRoot&) = delete;
+    AffinityRoot& operator=(AffinityRoot&&) = delete;
+
+    using SelfStartCnf = StartCnf<AffinityRoot>;
+
+    AffinityRoot(const Environment& env, int bridges, bool pinned)
+        : Actor(NAME.c_str(), env)
+        , bridges_(bridges)
+    {
+        listen<SelfStartCnf>([this](const SelfStartCnf&) { sendTick(); });
+        listen<Ack>([this](const Ack&) {
+            if (++acks_ < bridges_) {
+                return;
+            }
+            acks_ = 0;
+            latencies.push_back(elapsedNs(tickSent_));
+            if (++rounds_ < AFFINITY_ROUNDS) {
+                sendTick();
+            } else {
+                publish(std::make_unique<Stop>());
+            }
+        });
+        newBridges(std::make_integer_sequence<int, MAX_FAN>(), pinned);
+    }
+    ~AffinityRoot() override = default;
+
+    template <int... numbers>
+    void newBridges(std::integer_sequence<int, numbers...>, bool pinned)
+    {
+        ((numbers < bridges_ ? (void)newChild<StatefulBridge<numbers>>(pinned) : void()), ...);
+    }
+
+    void sendTick()
+    {
+        tickSent_ = Clock::now();
+        publish(std::make_unique<Tick>(tickSent_));
+    }
+
+    const int         bridges_;      /// number of bridges
+    int               acks_     = 0; /// acknowledges of the current tick
+    int               rounds_   = 0; /// ticks acknowledged by all bridges
+    Clock::time_point tickSent_ = {}; /// send time of the current tick
+
+    static constexpr const auto NAME = sstr::literal("AffinityRoot");
+};
+
+/**
+ * Listens, publishes to the new listen and unlistens when the message arrived, then starts over. The
+ * latency is the time from the listen call till the message is delivered to it.
+ */
+struct ChurnRoot : public Actor
+{
+    // not copyable or movable
+    ChurnRoot(const ChurnRoot&) = delete;
+    ChurnRoot(ChurnRoot&&)      = delete;
+
+    ChurnRoot& operator=(const ChurnRoot&) = delete;
+    ChurnRoot& operator=(ChurnRoot&&) = delete;
+
+    using SelfStartCnf = StartCnf<ChurnRoot>;
+
+    explicit ChurnRoot(const Environment& env)
+        : Actor(NAME.c_str(), env)
+    {
+        listen<SelfStartCnf>([this](const SelfStartCnf&) { churn(); });
+    }
+    ~ChurnRoot() override = default;
+
+    void churn()
+    {
+        const auto listened = Clock::now();
+        handle_             = listen<Poke>([this, listened](const Poke&) {
+            latencies.push_back(elapsedNs(listened));
+            unlisten<Poke>(handle_);
+            if (++rounds_ < CHURN_ROUNDS) {
+                churn();
+            } else {
+                publish(std::make_unique<Stop>());
+            }
+        });
+        publish(std::make_unique<Poke>());
+    }
+
+    CallBackHandle handle_ = 0; /// the current listen
+    int            rounds_ = 0; /// finished cycles
+
+    static constexpr const auto NAME = sstr::literal("ChurnRoot");
+};
+
+/**
+ * Round trip of a ping and its pong between two actors. Argument is the dispatcher count.
+ */
+void BM_ActorPingPong(benchmark::State& state)
+{
+    runCore<PingPongRoot>(state);
+    state.SetItemsProcessed(state.iterations() * ROUND_TRIPS * 2);
+}
+
+/**
+ * One publisher, each message is delivered to every receiver. Arguments are the dispatcher count and
+ * the number of receivers, items are the deliveries.
+ */
+void BM_ActorFanOut(benchmark::State& state)
+{
+    const auto receivers = static_cast<int>(state.range(1));
+    runCore<FanOutRoot>(state, receivers);
+    state.SetItemsProcessed(state.iterations() * FAN_ROUNDS * receivers);
+}
+
+/**
+ * Many publishers flood a single receiver. Arguments are the dispatcher count and the number of
+ * senders, items are the messages received.
+ */
+void BM_ActorFanIn(benchmark::State& state)
+{
+    const auto senders = static_cast<int>(state.range(1));
+    runCore<FanInRoot>(state, senders);
+    state.SetItemsProcessed(state.iterations() * FAN_IN_ROUNDS * FAN_IN_BURST * senders);
+}
+
+/**
+ * Listen and unlisten in a loop, each listen gets one message. Argument is the dispatcher count,
+ * items are the listen, deliver, unlisten cycles.
+ */
+void BM_ActorListenChurn(benchmark::State& state)
+{
+    runCore<ChurnRoot>(state);
+    state.SetItemsProcessed(state.iterations() * CHURN_ROUNDS);
+}
+
+/**
+ * One stateful bridge per dispatcher, floating or pinned to its own dispatcher. Arguments are the
+ * dispatcher count and 1 for pinned bridges, items are the ticks handled by the bridges. The cache
+ * miss rates come with --benchmark_perf_counters=L1-dcache-load-misses,LLC-load-misses when the
+ * benchmark library is built with libpfm, otherwise run the case under perf stat.
+ */
+void BM_ActorAffinity(benchmark::State& state)
+{
+    const auto bridges = std::min(static_cast<int>(state.range(0)), MAX_FAN);
+    runCore<AffinityRoot>(state, bridges, state.range(1) != 0);
+    state.SetItemsProcessed(state.iterations() * AFFINITY_ROUNDS * bridges);
+}
+
+} // namespace
+
+BENCHMARK(BM_ActorPingPong)
+    ->RangeMultiplier(2)
+    ->Range(1, maxDispatchers())
+    ->ArgName("dispatchers")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_ActorFanOut)
+    ->ArgsProduct({benchmark::CreateRange(1, maxDispatchers(), 2), {1, 4, MAX_FAN}})
+    ->ArgNames({"dispatchers", "receivers"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_ActorFanIn)
+    ->ArgsProduct({benchmark::CreateRange(1, maxDispatchers(), 2), {1, 4, MAX_FAN}})
+    ->ArgNames({"dispatchers", "senders"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_ActorListenChurn)
+    ->RangeMultiplier(2)
+    ->Range(1, maxDispatchers())
+    ->ArgName("dispatchers")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_ActorAffinity)
+    ->ArgsProduct({benchmark::CreateRange(1, maxDispatchers(), 2), {0, 1}})
+    ->ArgNames({"dispatchers", "pinned"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
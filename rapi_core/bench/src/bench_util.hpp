@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace adst::ep::test_engine::core::bench {
+
+/**
+ * Upper end for the dispatcher count arguments, the benchmarks double the count from 1 till here.
+ */
+inline int maxDispatchers()
+{
+    return static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+}
+
+/**
+ * @param values Latencies in ns, reordered.
+ * @param percentile Between 0 and 1.
+ * @return The latency in us the given part of the values is below of.
+ */
+inline double percentileUs(std::vector<std::int64_t>& values, double percentile)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    const auto index = static_cast<size_t>(percentile * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return static_cast<double>(values[index]) / 1000.0;
+}
+
+/**
+ * Adds the p50, p99 and max of the latencies as counters of the benchmark.
+ * @param state The running benchmark.
+ * @param latencies Latencies in ns, reordered.
+ */
+inline void reportLatencies(benchmark::State& state, std::vector<std::int64_t>& latencies)
+{
+    state.counters["p50_us"] = percentileUs(latencies, 0.5);
+    state.counters["p99_us"] = percentileUs(latencies, 0.99);
+    state.counters["max_us"] = percentileUs(latencies, 1.0);
+}
+
+/**
+ * @param since A time point taken earlier.
+ * @return The time elapsed in ns.
+ */
+inline std::int64_t elapsedNs(std::chrono::steady_clock::time_point since)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since).count();
+}
+
+} // namespace adst::ep::test_engine::core::bench
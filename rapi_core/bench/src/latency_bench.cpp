@@ -0,0 +1,212 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "adstutil_cxx/static_string.hpp"
+#include "bench_util.hpp"
+#include "config_cxx/config_and_logger.hpp"
+#include "core/core.hpp"
+
+using adst::common::Config;
+using adst::common::ConfigAndLogger;
+using adst::common::Error;
+using adst::ep::test_engine::core::Actor;
+using adst::ep::test_engine::core::Core;
+using adst::ep::test_engine::core::Environment;
+using adst::ep::test_engine::core::StartCnf;
+using adst::ep::test_engine::core::Stop;
+using adst::ep::test_engine::core::bench::reportLatencies;
+
+namespace sstr = ak_toolkit::static_str;
+
+namespace {
+
+constexpr int  LIGHT_ACTOR_COUNT = 16;  /// actors answering every probe
+constexpr int  PROBE_COUNT       = 200; /// probes sent in one run of the core
+constexpr int  FLOOD_DEPTH       = 64;  /// messages the heavy actor keeps queued for itself
+constexpr auto WORK_DURATION     = std::chrono::microseconds{2}; /// time the heavy actor spends on a message
+
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const adst::common::OnErrorCallBack onError = [](const Error& error) {
+    std::cerr << error.errorCodeName_.second << std::endl;
+    exit(1);
+};
+
+/**
+ * A single dispatcher, so the light actors only get to run when the heavy actor gives up the dispatcher.
+ */
+const ConfigAndLogger& getConfigAndLogger()
+{
+    static const ConfigAndLogger confLog = {Config{onError, 1}};
+    return confLog;
+}
+
+std::atomic<bool>         flooding = {false}; /// the heavy actor republishes its work while set
+std::vector<std::int64_t> latencies;           /// probe latencies in ns of all runs of a benchmark
+
+struct Work final
+{
+    static constexpr auto NAME = sstr::literal("Work");
+};
+
+struct Probe final
+{
+    static constexpr auto NAME = sstr::literal("Probe");
+};
+
+struct ProbeReply final
+{
+    static constexpr auto NAME = sstr::literal("ProbeReply");
+};
+
+/**
+ * Chatty actor, each message it handles takes a while and queues a new message for itself.
+ */
+struct HeavyActor : public Actor
+{
+    // not copyable or movable
+    HeavyActor(const HeavyActor&) = delete;
+    HeavyActor(HeavyActor&&)      = delete;
+
+    HeavyActor& operator=(const HeavyActor&) = delete;
+    HeavyActor& operator=(HeavyActor&&) = delete;
+
+    HeavyActor(const Environment& env, int maxMessages, std::chrono::microseconds maxTime)
+        : Actor(NAME.c_str(), env)
+    {
+        setActivationBudget(maxMessages, maxTime);
+        listen<Work>([this](const Work&) {
+            const auto end = std::chrono::steady_clock::now() + WORK_DURATION;
+            while (std::chrono::steady_clock::now() < end) {
+            }
+            if (flooding) {
+                publish(std::make_unique<Work>());
+            }
+        });
+    }
+    ~HeavyActor() override = default;
+
+    static constexpr const auto NAME = sstr::literal("HeavyActor");
+};
+
+/**
+ * Each light actor has its own type, children of the same type can not be told apart by the life cycle.
+ */
+template <int number>
+struct LightActor : public Actor
+{
+    // not copyable or movable
+    LightActor(const LightActor&) = delete;
+    LightActor(LightActor&&)      = delete;
+
+    LightActor& operator=(const LightActor&) = delete;
+    LightActor& operator=(LightActor&&) = delete;
+
+    explicit LightActor(const Environment& env)
+        : Actor(NAME.c_str(), env)
+    {
+        listen<Probe>([this](const Probe&) { publish(std::make_unique<ProbeReply>()); });
+    }
+    ~LightActor() override = default;
+
+    static constexpr const auto NAME = sstr::literal("LightActor");
+};
+
+/**
+ * Starts the flood of the heavy actor, then sends the probes one after the other. The latency of a
+ * probe is the time till all light actors replied.
+ */
+struct LatencyRoot : public Actor
+{
+    // not copyable or movable
+    LatencyRoot(const LatencyRoot&) = delete;
+    LatencyRoot(LatencyRoot&&)      = delete;
+
+    LatencyRoot& operator=(const LatencyRoot&) = delete;
+    LatencyRoot& operator=(LatencyRoot&&) = delete;
+
+    using SelfStartCnf = StartCnf<LatencyRoot>;
+
+    LatencyRoot(const Environment& env, int maxMessages, std::chrono::microseconds maxTime)
+        : Actor(NAME.c_str(), env)
+    {
+        listen<SelfStartCnf>([this](const SelfStartCnf&) {
+            flooding = true;
+            for (int work = 0; work < FLOOD_DEPTH; ++work) {
+                publish(std::make_unique<Work>());
+            }
+            sendProbe();
+        });
+        listen<ProbeReply>([this](const ProbeReply&) {
+            if (++replyCount_ < LIGHT_ACTOR_COUNT) {
+                return;
+            }
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now() - probeSent_)
+                                    .count());
+            if (++probeCount_ < PROBE_COUNT) {
+                sendProbe();
+            } else {
+                flooding = false;
+                publish(std::make_unique<Stop>());
+            }
+        });
+        newChild<HeavyActor>(maxMessages, maxTime);
+        newLightChildren(std::make_integer_sequence<int, LIGHT_ACTOR_COUNT>());
+    }
+    ~LatencyRoot() override = default;
+
+    template <int... numbers>
+    void newLightChildren(std::integer_sequence<int, numbers...>)
+    {
+        (newChild<LightActor<numbers>>(), ...);
+    }
+
+    void sendProbe()
+    {
+        replyCount_ = 0;
+        probeSent_  = std::chrono::steady_clock::now();
+        publish(std::make_unique<Probe>());
+    }
+
+    int                                   replyCount_ = 0;  /// replies to the current probe
+    int                                   probeCount_ = 0;  /// probes answered by all light actors
+    std::chrono::steady_clock::time_point probeSent_  = {}; /// send time of the current probe
+
+    static constexpr const auto NAME = sstr::literal("LatencyRoot");
+};
+
+/**
+ * Probe latency of the light actors while one heavy actor floods itself. Arguments are the message
+ * budget and the time slice (us) of the heavy actor. A heavy actor without any budget would keep the
+ * only dispatcher forever, so there is no such case.
+ */
+void BM_LightActorLatency(benchmark::State& state)
+{
+    getConfigAndLogger();
+    latencies.clear();
+    for (auto _ : state) {
+        Core core(getConfigAndLogger());
+        core.init<LatencyRoot>(static_cast<int>(state.range(0)), std::chrono::microseconds{state.range(1)});
+        core.run();
+    }
+    reportLatencies(state, latencies);
+}
+
+} // namespace
+
+BENCHMARK(BM_LightActorLatency)
+    ->Args({1, 0})
+    ->Args({8, 0})
+    ->Args({64, 0})
+    ->Args({512, 0})
+    ->Args({0, 20})
+    ->Args({0, 100})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
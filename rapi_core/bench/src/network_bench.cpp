@@ -0,0 +1,178 @@
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "adstutil_cxx/static_string.hpp"
+#include "config_cxx/config_and_logger.hpp"
+#include "core/actor.hpp"
+#include "core/network.hpp"
+
+using adst::common::Config;
+using adst::common::ConfigAndLogger;
+using adst::common::Error;
+using adst::ep::test_engine::core::Actor;
+using adst::ep::test_engine::core::Network;
+
+namespace sstr = ak_toolkit::static_str;
+
+namespace {
+
+constexpr int MAX_PUBLISHERS = 8; /// one event type per publisher thread
+
+template <int number>
+struct BenchEvent final
+{
+    static constexpr auto NAME = sstr::literal("BenchEvent");
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const adst::common::OnErrorCallBack onError = [](const Error& error) {
+    std::cerr << error.errorCodeName_.second << std::endl;
+    exit(1);
+};
+
+/**
+ * The trace channels of the network are shared by the logger, so it must exist before any network.
+ */
+const ConfigAndLogger& getConfigAndLogger()
+{
+    static const ConfigAndLogger confLog = {Config{onError, Config::DEFAULT_NUMBER_OF_DISPATCHERS}};
+    return confLog;
+}
+
+/**
+ * Every listener counts on its own cache line, so only the network itself can limit the scaling.
+ */
+struct alignas(64) ListenerCount
+{
+    std::atomic<std::int64_t> count_ = {0};
+};
+
+ListenerCount listenerCounts[MAX_PUBLISHERS]; // NOLINT(cppcoreguidelines-avoid-c-arrays)
+
+template <int number>
+void listenOn(Network& network)
+{
+    network.listen<BenchEvent<number>>([](const std::shared_ptr<BenchEvent<number>>) {
+        listenerCounts[number].count_.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+template <int... numbers>
+Network& createNetwork(std::integer_sequence<int, numbers...>)
+{
+    getConfigAndLogger();
+    static Network network;
+    (listenOn<numbers>(network), ...);
+    return network;
+}
+
+Network& getNetwork()
+{
+    static Network& network = createNetwork(std::make_integer_sequence<int, MAX_PUBLISHERS>());
+    return network;
+}
+
+template <int number>
+void publishLoop(benchmark::State& state, Network& network)
+{
+    auto event = std::make_shared<BenchEvent<number>>();
+    for (auto _ : state) {
+        network.publish(event);
+    }
+}
+
+template <int... numbers>
+void publishOwnType(benchmark::State& state, Network& network, std::integer_sequence<int, numbers...>)
+{
+    // selects the event type matching the thread index
+    ((state.thread_index() % MAX_PUBLISHERS == numbers ? publishLoop<numbers>(state, network) : void()), ...);
+}
+
+/**
+ * Each publisher thread publishes its own event type. Since publish takes no lock and the listener
+ * snapshots of different types are independent, the throughput shall scale with the thread count.
+ */
+void BM_NetworkPublishDifferentTypes(benchmark::State& state)
+{
+    publishOwnType(state, getNetwork(), std::make_integer_sequence<int, MAX_PUBLISHERS>());
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * All publisher threads publish the same event type, they share the read counter of the type.
+ */
+void BM_NetworkPublishSameType(benchmark::State& state)
+{
+    publishLoop<0>(state, getNetwork());
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Publishes a new event in each iteration, created by std::make_unique (arg 0: event and shared
+ * state are two allocations) or by Actor::make (arg 1: one block recycled from the pool).
+ */
+void BM_NetworkPublishNewEvent(benchmark::State& state)
+{
+    using Event   = BenchEvent<0>;
+    auto& network = getNetwork();
+    if (state.range(0) == 0) {
+        for (auto _ : state) {
+            network.publish(std::make_unique<Event>());
+        }
+    } else {
+        for (auto _ : state) {
+            network.publish(Actor::make<Event>());
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Publishes with the core channel letting DEBUG pass (arg 0) or dropping it (arg 1). Dropped records
+ * only cost the verbosity check, their arguments are not evaluated. Building with
+ * ADSTLOG_DEBUG_LEVEL_CORE_COMPILED_IN=OFF removes the check as well.
+ */
+void BM_NetworkPublishLogging(benchmark::State& state)
+{
+    auto&      network = getNetwork();
+    IP7_Trace* core    = P7_Get_Shared_Trace(ADSTLOG_CORE_CH_NAME);
+    const auto verbose = core->Get_Verbosity(nullptr);
+    core->Set_Verbosity(nullptr, state.range(0) == 0 ? EP7TRACE_LEVEL_DEBUG : EP7TRACE_LEVEL_ERROR);
+    auto event = std::make_shared<BenchEvent<0>>();
+    for (auto _ : state) {
+        network.publish(event);
+    }
+    core->Set_Verbosity(nullptr, verbose);
+    core->Release();
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Cost of recording one step of the message flow with the flow trace off (arg 0) and on (arg 1). The
+ * ring is smaller than the iterations, so the steady state of overwriting the oldest records is measured.
+ */
+void BM_FlowTraceRecord(benchmark::State& state)
+{
+    using adst::ep::test_engine::core::impl::FlowEvent;
+    using adst::ep::test_engine::core::impl::FlowTrace;
+    if (state.range(0) != 0) {
+        FlowTrace::enable();
+    }
+    for (auto _ : state) {
+        FlowTrace::record<BenchEvent<0>>(FlowEvent::QUEUE, 0);
+    }
+    FlowTrace::disable();
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_FlowTraceRecord)->Arg(0)->Arg(1);
+BENCHMARK(BM_NetworkPublishLogging)->Arg(0)->Arg(1);
+BENCHMARK(BM_NetworkPublishNewEvent)->Arg(0)->Arg(1)->ThreadRange(1, MAX_PUBLISHERS)->UseRealTime();
+BENCHMARK(BM_NetworkPublishDifferentTypes)->ThreadRange(1, MAX_PUBLISHERS)->UseRealTime();
+BENCHMARK(BM_NetworkPublishSameType)->ThreadRange(1, MAX_PUBLISHERS)->UseRealTime();
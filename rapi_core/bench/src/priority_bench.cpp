@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "config_cxx/config_and_logger.hpp"
+#include "core/priority.hpp"
+
+using adst::common::Config;
+using adst::common::ConfigAndLogger;
+using adst::common::Error;
+using adst::ep::test_engine::core::DispatcherSettings;
+using adst::ep::test_engine::core::Priority;
+
+namespace {
+
+constexpr int CHAIN_COUNT  = 64;   /// number of independent job chains scheduled from main per iteration
+constexpr int CHAIN_LENGTH = 256;  /// each job of a chain schedules the next one from a dispatcher
+constexpr int JOB_WORK     = 200;  /// loop count simulating the work of a single actor activation
+
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const adst::common::OnErrorCallBack onError = [](const Error& error) {
+    std::cerr << error.errorCodeName_.second << std::endl;
+    exit(1);
+};
+
+/**
+ * The trace channels of the priority are shared by the logger, so it must exist before any priority.
+ */
+const ConfigAndLogger& getConfigAndLogger()
+{
+    static const ConfigAndLogger confLog = {Config{onError, Config::DEFAULT_NUMBER_OF_DISPATCHERS}};
+    return confLog;
+}
+
+void scheduleChain(Priority& prio, int remaining)
+{
+    prio.schedule([&prio, remaining] {
+        for (int work = 0; work < JOB_WORK; ++work) {
+            benchmark::DoNotOptimize(work);
+        }
+        if (remaining > 1) {
+            scheduleChain(prio, remaining - 1);
+        }
+    });
+}
+
+/**
+ * Measures how the number of executed jobs per second scales with the dispatcher count. The chains
+ * are seeded from main (injection queue) and continue from the dispatchers (local queues), so both
+ * paths and stealing are exercised.
+ */
+void BM_PriorityScheduleThroughput(benchmark::State& state)
+{
+    getConfigAndLogger();
+    Priority prio(static_cast<int>(state.range(0)), onError);
+    prio.start();
+    for (auto _ : state) {
+        for (int chain = 0; chain < CHAIN_COUNT; ++chain) {
+            scheduleChain(prio, CHAIN_LENGTH);
+        }
+        prio.waitForIdle();
+    }
+    prio.stop();
+    state.SetItemsProcessed(state.iterations() * CHAIN_COUNT * CHAIN_LENGTH);
+}
+
+/**
+ * Measures the time from schedule on an idle priority till the job starts on the dispatcher for each
+ * idle policy. The gap between the jobs decides whether a spinning dispatcher is still spinning or
+ * has already parked when the next job arrives.
+ */
+void BM_PriorityWakeUpLatency(benchmark::State& state)
+{
+    using Clock = std::chrono::steady_clock;
+    getConfigAndLogger();
+    DispatcherSettings settings;
+    settings.idlePolicy_ = static_cast<DispatcherSettings::IdlePolicy>(state.range(0));
+    const auto gap       = std::chrono::microseconds{state.range(1)};
+    Priority   prio(1, onError, settings);
+    prio.start();
+    std::atomic<Clock::rep> started = {0};
+    for (auto _ : state) {
+        std::this_thread::sleep_for(gap);
+        started.store(0);
+        const auto scheduled = Clock::now();
+        prio.schedule([&started] { started.store(Clock::now().time_since_epoch().count()); });
+        Clock::rep startedAt = 0;
+        while ((startedAt = started.load()) == 0) {
+            std::this_thread::yield();
+        }
+        const auto latency = Clock::time_point{Clock::duration{startedAt}} - scheduled;
+        state.SetIterationTime(std::chrono::duration<double>(latency).count());
+    }
+    prio.stop();
+}
+
+const int MAX_DISPATCHERS = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+} // namespace
+
+BENCHMARK(BM_PriorityScheduleThroughput)->DenseRange(1, MAX_DISPATCHERS)->UseRealTime();
+// idle policy (PARK, SPIN, BUSY_SPIN) x gap between two jobs in microseconds
+BENCHMARK(BM_PriorityWakeUpLatency)
+    ->ArgsProduct({{0, 1, 2}, {10, 1000}})
+    ->ArgNames({"policy", "gapUs"})
+    ->UseManualTime();
+
+BENCHMARK_MAIN();
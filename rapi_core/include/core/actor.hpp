@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -9,6 +12,9 @@
 
 #include "core/core_types.hpp"
 #include "core/environment.hpp"
+#include "core/impl/flow_trace.hpp"
+#include "core/impl/message_pool.hpp"
+#include "core/impl/mpsc_queue.hpp"
 #include "core/message.hpp"
 
 namespace adst::ep::test_engine::core {
@@ -33,13 +39,15 @@ public:
     Actor(Actor&&)                 = delete;
     Actor& operator=(Actor&&) = delete;
 
-    virtual ~Actor() = default;
+    virtual ~Actor();
 
     using ChildHandle = size_t;                /// Children are identified by a unique handle.
     using PortPtr     = std::unique_ptr<Port>; /// Ports are owned by actors.
     using PortList    = std::vector<PortPtr>;  /// Store for the ports.
     using PortIndex   = size_t;                /// Ports are indexed by PortIndex.
 
+    static constexpr PortIndex DEFAULT_PORT = 0; /// Port on the default network, receives the life cycle.
+
     /**
      * Actor are always constructed by providing a name and the ADST environment.
      * @param name Name of the derived actor.
@@ -92,21 +100,79 @@ public:
     template <typename TMessage>
     void publish(std::unique_ptr<TMessage> msg)
     {
-        LOG_CH_D(MSG_TX, "%s", impl::getTypeName<TMessage>().c_str());
-        if constexpr (!std::is_base_of<PrivStartHelper, TMessage>::value &&
-                      !std::is_base_of<PrivStopHelper, TMessage>::value &&
-                      !std::is_base_of<ReqHelper, TMessage>::value &&
-                      !std::is_base_of<StopCnfHelper, TMessage>::value) {
-            if (state_ != ActorState::STARTED) {
-                env_.configAndLogger_.config_.onErrorCallBack_(adst::common::Error{
-                    {5, fmt::format("{}.publish<{}>(...) called in '{}' state, publish only allowed in STARTED",
-                                    getName(), impl::getTypeName<TMessage>(), actorStateToStr(state_))}});
-            }
-        }
+        checkPublish<TMessage>();
+        env_.network_.publish(std::move(msg));
+    }
 
+    /**
+     * Same as publish(std::unique_ptr<TMessage>) for messages created by make(), the message is
+     * shared with the listeners without an extra allocation.
+     *
+     * @tparam TMessage The type of the message to be broadcasted.
+     * @param msg The message, shall not be modified after publish.
+     */
+    template <typename TMessage>
+    void publish(std::shared_ptr<TMessage> msg)
+    {
+        checkPublish<TMessage>();
         env_.network_.publish(std::move(msg));
     }
 
+    /**
+     * Same as publish(std::unique_ptr<TMessage>) on the network of the given port instead of the
+     * default network.
+     *
+     * @tparam TMessage The type of the message to be broadcasted.
+     * @param port The port returned by attachPort().
+     * @param msg The message, the ownership is transferred.
+     */
+    template <typename TMessage>
+    void publishOn(PortIndex port, std::unique_ptr<TMessage> msg);
+
+    /**
+     * Same as publish(std::shared_ptr<TMessage>) on the network of the given port instead of the
+     * default network.
+     *
+     * @tparam TMessage The type of the message to be broadcasted.
+     * @param port The port returned by attachPort().
+     * @param msg The message, shall not be modified after publish.
+     */
+    template <typename TMessage>
+    void publishOn(PortIndex port, std::shared_ptr<TMessage> msg);
+
+    /**
+     * Creates a message in memory recycled from the messages of the same size which are already
+     * released, the message and its reference count are a single block. Use it for frequently
+     * published messages, the result can be passed to publish().
+     *
+     * @tparam TMessage The type of the message to create.
+     * @tparam Args Constructor parameter types perfect forwarded to TMessage.
+     * @param args Actual constructor argument list.
+     * @return The new message.
+     */
+    template <typename TMessage, typename... Args>
+    static std::shared_ptr<TMessage> make(Args&&... args)
+    {
+        return std::allocate_shared<TMessage>(impl::PoolAllocator<TMessage>{}, std::forward<Args>(args)...);
+    }
+
+    /**
+     * Fills the pool used by make<TMessage>() so that the messages in flight do not allocate even
+     * when the threads releasing them keep some blocks for themselves. Call it during initialization.
+     *
+     * @tparam TMessage The type of the message, shall be default constructible.
+     * @param count Number of blocks to add to the pool.
+     */
+    template <typename TMessage>
+    static void reserve(std::size_t count)
+    {
+        std::vector<std::shared_ptr<TMessage>> messages;
+        messages.reserve(count);
+        for (std::size_t index = 0; index < count; ++index) {
+            messages.emplace_back(make<TMessage>());
+        }
+    }
+
     /**
      * Registers a callback function for listening to messages with TMessage type.
      * @tparam TMessage Message type to listen to.
@@ -116,6 +182,24 @@ public:
     template <typename TMessage>
     CallBackHandle listen(std::function<void(const TMessage&)> callBack);
 
+    /**
+     * Same as listen(std::function<void(const TMessage&)>), but only the newest queued message of the
+     * type (or per key) is kept, a newer one replaces it. Meant for fields and cyclic notifications
+     * where a slow actor shall skip stale values instead of processing all of them. Conflation
+     * applies to all listeners of TMessage on the port.
+     *
+     * @tparam TMessage Message type to listen to.
+     * @param callBack Callback function will be called with the newest instance of TMessage.
+     * @param keyOf Key of a message, messages with different keys are kept apart. Empty for a single
+     *        slot per type.
+     * @param port DEFAULT_PORT or a port returned by attachPort().
+     * @return A unique handle which can be used to unlisten.
+     */
+    template <typename TMessage>
+    CallBackHandle listenLatest(std::function<void(const TMessage&)>          callBack,
+                                std::function<ConflationKey(const TMessage&)> keyOf = nullptr,
+                                PortIndex                                     port  = DEFAULT_PORT);
+
     /**
      * Adds the listen with a predefined handle. Use if you want to unlisten in the callback
      * @tparam TMessage Message type to listen to.
@@ -133,6 +217,38 @@ public:
     template <typename TMessage>
     void unlisten(const CallBackHandle handle);
 
+    /**
+     * Same as listen(std::function<void(const TMessage&)>) on the given port instead of the default
+     * one. The life cycle messages are only delivered to the default port.
+     * @tparam TMessage Message type to listen to.
+     * @param port The port returned by attachPort().
+     * @param callBack Callback function will be called with an instance of TMessage when a publish happened,
+     * @return A unique handle which can be used to unlistenOn.
+     */
+    template <typename TMessage>
+    CallBackHandle listenOn(PortIndex port, std::function<void(const TMessage&)> callBack);
+
+    /**
+     * Unregisters a callback registered by listenOn().
+     * @tparam TMessage The message type to look for.
+     * @param port The port given to listenOn().
+     * @param handle The handle returned by listenOn().
+     */
+    template <typename TMessage>
+    void unlistenOn(PortIndex port, const CallBackHandle handle);
+
+    /**
+     * Bridges a message type between two networks, each TMessage received on one port is published as
+     * a copy on the network of the other port. Forwarding the same type in both directions between
+     * two networks would bounce each message forever.
+     * @tparam TMessage Message type to forward, shall be copy constructible.
+     * @param from The port receiving the messages.
+     * @param to The port the messages are published on.
+     * @return The handle of the listen on from, forwarding stops with unlistenOn<TMessage>(from, handle).
+     */
+    template <typename TMessage>
+    CallBackHandle forward(PortIndex from, PortIndex to);
+
     /**
      * Creates an actor of type TChild.
      *
@@ -156,6 +272,27 @@ public:
     template <typename TChild, typename... Args>
     ChildHandle newChild(Args&&... args);
 
+    /**
+     * Creates an actor of type TChild executed at the given priority level. Children created without
+     * a level inherit the level of the parent.
+     *
+     * @tparam TChild The user provided type for the actor to be created.
+     * @tparam Args Possible constructor parameter types perfect forwarded to the new child
+     * @param level The priority level executing the child.
+     * @param args Actual constructor argument list.
+     * @return Unique handle identifying the newly created TChild.
+     */
+    template <typename TChild, typename... Args>
+    ChildHandle newChild(PriorityLevel level, Args&&... args);
+
+    /**
+     * @return The priority level executing this actor.
+     */
+    PriorityLevel getPriorityLevel() const
+    {
+        return priorityLevel_;
+    }
+
     /**
      * Gets a reference to a child identified by the handle.
      * @param handle Unique identifier assigned during child creation.
@@ -173,7 +310,7 @@ public:
 #ifdef ADST_CORE_TEST_ENABLED
     /**
      * Only required (and shall only be used) by tests.
-     * @param index Index of the port (as of today only 0 is valid).
+     * @param index Index of the port, DEFAULT_PORT or one returned by attachPort().
      * @return Reference to the port selected by index.
      */
     Port& getPortForTest(PortIndex index) const
@@ -198,6 +335,98 @@ protected:
         return children_.size();
     }
 
+    /**
+     * Limits the work the actor does each time it gets a dispatcher, the default comes from Config.
+     * When the budget is used up and the actor still has work, it is queued again behind the actors
+     * already waiting for a dispatcher. Shall be called in actor context (e.g. in the constructor).
+     *
+     * @param maxMessages Number of messages dispatched in one activation, 0 means no limit.
+     * @param maxTime Time slice of one activation, 0 means no limit.
+     */
+    void setActivationBudget(int maxMessages, std::chrono::microseconds maxTime = std::chrono::microseconds{0})
+    {
+        activationBudget_ = {maxMessages, maxTime};
+    }
+
+    /**
+     * Attaches a new port of the actor to a network, so the actor can talk on more than the default
+     * network. The life cycle always runs on DEFAULT_PORT. Each port has its own queue and takes turns
+     * with the other ports in the mailbox of the actor. Shall be called in actor context (e.g. in the
+     * constructor).
+     *
+     * @param network Name of the network, Environment::DEFAULT_NETWORK for the default one.
+     * @param maxMessages Messages the port dispatches per turn, 0 means no limit, see setPortBudget().
+     * @return Index of the new port for publishOn(), listenOn() and unlistenOn().
+     */
+    PortIndex attachPort(const std::string& network, int maxMessages = 0);
+
+    /**
+     * Binds the actor to one dispatcher of its priority, so its state stays in the cache of one cpu
+     * instead of following the dispatcher which happens to pick it up. The other dispatchers never
+     * steal a bound actor, a busy bound actor therefore delays the other actors bound to the same
+     * dispatcher. Actors float by default, the actors section of the config can bind them by name:
+     *
+     *     actors:
+     *       SomeIpBridge:
+     *         dispatcher: 2
+     *
+     * Shall be called in the constructor, before the actor is scheduled the first time.
+     *
+     * @param dispatcher Index of the dispatcher, taken modulo the dispatcher count of the priority.
+     */
+    void pinToDispatcher(std::size_t dispatcher)
+    {
+        pinnedDispatcher_ = static_cast<int>(dispatcher);
+    }
+
+    /**
+     * Bounds the messages queued on a port, the default comes from the ports section of the config.
+     * Shall be called in actor context (e.g. in the constructor).
+     *
+     * @param port DEFAULT_PORT or a port returned by attachPort().
+     * @param capacity Messages queued at most, 0 means no limit.
+     * @param policy What happens to a new message when the port is full.
+     */
+    void setPortLimit(PortIndex port, std::size_t capacity, OverloadPolicy policy);
+
+    /**
+     * Limits the messages a port dispatches each time it gets its turn. When the budget is used up
+     * the port queues itself again behind the other ports of the actor, e.g. so a high-rate data port
+     * does not keep the control port waiting. The activation budget still applies on top. Shall be
+     * called in actor context (e.g. in the constructor).
+     *
+     * @param port DEFAULT_PORT or a port returned by attachPort().
+     * @param maxMessages Messages dispatched per turn, 0 means no limit.
+     */
+    void setPortBudget(PortIndex port, int maxMessages);
+
+    /**
+     * Receives the datagrams of a socket through the I/O engine of the dispatcher the actor is bound
+     * to, without a thread of its own. Whenever the engine has datagrams of the socket it hands them to
+     * callBack in actor context, in place: they are valid till callBack returns and the socket is not
+     * read for the actor again before. The actor shall be bound to a dispatcher (see pinToDispatcher())
+     * of a priority with an I/O backend:
+     *
+     *     dispatchers:
+     *       normal:
+     *         io: uring # or epoll
+     *
+     * Shall be called in actor context, typically in the listener of the own StartCnf so the callback
+     * can publish. The socket is registered with the next activation of the actor. The actor stops
+     * receiving with stopReceive() or when it is stopped, the caller keeps owning the socket.
+     *
+     * @param fd An IPv4 datagram socket.
+     * @param callBack Called with the datagrams of one wake-up of the engine.
+     */
+    void receive(int fd, ReceiveCallBack callBack);
+
+    /**
+     * Stops receiving from a socket of receive(), datagrams not yet handed to the callback are
+     * dropped. Shall be called in actor context.
+     * @param fd The socket.
+     */
+    void stopReceive(int fd);
+
     const std::string name_ = "Actor"; /// stores the name of the actor.
 
     /**
@@ -262,6 +491,26 @@ private:
         unsigned int          childrenCnfCount_ = 0; /// the number of children that has finished starting / stopping
     };
 
+    /**
+     * A socket of receive(). Kept till the actor is destroyed, its batch job might still be queued
+     * when the socket is removed.
+     */
+    struct SocketReceiver
+    {
+        SocketReceiver(Actor& owner, int fd, ReceiveCallBack callBack)
+            : fd_(fd)
+            , callBack_(std::move(callBack))
+            , batchJob_([&owner, this] { owner.dispatchBatch(*this); })
+        {
+        }
+
+        int               fd_;                   /// the socket, -1 after it has been stopped
+        ReceiveCallBack   callBack_;             /// the callback of receive()
+        Job               batchJob_;             /// queued in the mailbox when the engine has a batch
+        impl::IoEngine*   engine_     = nullptr; /// the engine of the bound dispatcher
+        impl::IoReceiver* ioReceiver_ = nullptr; /// the registration on engine_, nullptr when not receiving
+    };
+
     struct PrivStartHelper
     {
     };
@@ -305,6 +554,9 @@ private:
         if (state != state_) {
             LOG_C_D("'%s' -> '%s'", actorStateToStr(state_), actorStateToStr(state));
             state_ = state;
+            if (state_ == ActorState::STOPPED && !receivers_.empty()) {
+                stopReceiving();
+            }
         }
     }
 
@@ -332,14 +584,108 @@ private:
     }
 
     /**
-     * Consumes all callbacks in the queue. This functions is called from priority.
+     * Consumes the callbacks in the queue till it is empty or the activation budget is used up, in
+     * the later case the actor is scheduled on the priority again. This functions is called from priority.
      */
     void consume();
 
     /**
-     * Schedules actor on the priority.
+     * Queues a callback in the mailbox and schedules actor on the priority.
+     * @param callBack The callback to execute in actor context.
      */
-    void schedule(std::function<void()>);
+    void schedule(CallBack callBack);
+
+    /**
+     * Queues a job owned by the caller in the mailbox and schedules actor on the priority. Used by
+     * the ports, they reuse the same job so queueing work for the actor does not allocate.
+     * @param job The job to execute in actor context, it must stay alive until it has been executed.
+     */
+    void schedule(Job& job);
+
+    /**
+     * Schedules consumeJob_ on the priority, on the bound dispatcher if there is one.
+     */
+    void post();
+
+    /**
+     * Sets scheduled_ to false when the mailbox is empty. A schedule racing with the release might
+     * have queued a callback without posting the actor, in that case scheduled_ is taken back.
+     * @return True when the caller owns scheduled_ again and the mailbox shall be consumed.
+     */
+    bool releaseScheduled();
+
+    /**
+     * Registers a socket of receive() on the engine of the dispatcher running the actor.
+     */
+    void startReceive(SocketReceiver& receiver);
+
+    /**
+     * Removes a socket of receive() from its engine.
+     */
+    void stopReceive(SocketReceiver& receiver);
+
+    /**
+     * Removes all sockets of receive(), called when the actor is stopped.
+     */
+    void stopReceiving();
+
+    /**
+     * Hands the batch of a socket to its callback and gives the buffers back to the engine.
+     */
+    void dispatchBatch(SocketReceiver& receiver);
+
+    /**
+     * Reports an error if TMessage is not allowed to be published in the current state. Only the life
+     * cycle messages can be published before the actor is started.
+     * @tparam TMessage The type of the message to be published.
+     */
+    template <typename TMessage>
+    void checkPublish()
+    {
+        LOG_CH_D(MSG_TX, "%s", impl::getTypeName<TMessage>());
+        impl::FlowTrace::record<TMessage>(impl::FlowEvent::PUBLISH, flowId_);
+        if constexpr (!std::is_base_of<PrivStartHelper, TMessage>::value &&
+                      !std::is_base_of<PrivStopHelper, TMessage>::value &&
+                      !std::is_base_of<ReqHelper, TMessage>::value &&
+                      !std::is_base_of<StopCnfHelper, TMessage>::value) {
+            if (state_ != ActorState::STARTED) {
+                env_.configAndLogger_.config_.onErrorCallBack_(adst::common::Error{
+                    {5, fmt::format("{}.publish<{}>(...) called in '{}' state, publish only allowed in STARTED",
+                                    getName(), impl::getTypeName<TMessage>(), actorStateToStr(state_))}});
+            }
+        }
+    }
+
+    /**
+     * Selects the priority executing the actor. Called by the life cycle before the actor is posted
+     * the first time.
+     * @param level The priority level of the actor.
+     */
+    void setPriorityLevel(PriorityLevel level)
+    {
+        priorityLevel_ = level;
+        priority_      = &env_.getPriority(level);
+    }
+
+    /**
+     * Limits of a single activation (one consume() call), 0 means no limit.
+     */
+    struct ActivationBudget
+    {
+        int                       maxMessages_; /// messages dispatched by the ports
+        std::chrono::microseconds maxTime_;     /// time spent in consume()
+    };
+
+    /**
+     * Resets the budget at the beginning of consume().
+     */
+    void startActivation();
+
+    /**
+     * Called by the ports after each dispatched message.
+     * @return True when the budget of the current activation is used up.
+     */
+    bool chargeActivation();
 
     /**
      * Creates a new unique value for a child.
@@ -352,24 +698,37 @@ private:
 
     ChildHandle childHandleCounter_ = 0; /// counter implements unique id handling in child creation
 
-    // Only the queue is protected against multi threading since the only function allowed to be called
+    // Only the mailbox is accessed from multiple threads since the only function allowed to be called
     // from other thread is schedule(..). All other functions shall only be called via callbacks.
     //
-    // Callbacks are consumed as long as callBackQueue_ is not empty.
+    // Callbacks are consumed as long as mailbox_ is not empty. Whoever changes scheduled_ from false
+    // to true posts consumeJob_ on the priority, so the actor is never queued or executed twice.
     //
     // Synchronisation is needed for destructor and for constructor calls since it could be that
     // while constructor is running a schedule is called because a message has been sent to the
-    // actor. Therefore scheduling of this case shall be postponed.
+    // actor. Therefore scheduled_ is true during construction and ctorFinished() posts the actor.
     //
     // Same story for destructor when there is a callback running and we call the destructor it
-    // shall wait until the callback / queue is consumed.
-    std::condition_variable           constDestEvent_;  /// signals unlock scheduler and dest
-    bool                              scheduled_;       /// true when Actor is scheduled or executing a callback
-    std::deque<std::function<void()>> callBackQueue_;   /// stores ports which have work to do
-    std::mutex                        callBackMutex_;   /// protects the callBackQueue_
-    std::unique_lock<std::mutex>      ctorDtorLock_;    /// used by ctor and dtor sync with derived callers.
-    PortList                          ports_ = {};      /// Actor input ports as of now only get created
-    LifeCycleHelper                   lifeCycleHelper_; /// sticks together the data of the life cycle
+    // shall wait until the mailbox is consumed and consume() has returned.
+    const std::uint32_t               flowId_;              /// identifies the actor in the flow trace
+    PriorityLevel                     priorityLevel_;       /// the level the actor is executed at
+    Priority*                         priority_;            /// the priority of priorityLevel_
+    int                               pinnedDispatcher_;    /// the dispatcher executing the actor, -1 for any
+    Job                               consumeJob_;          /// scheduled on the priority to consume the mailbox
+    impl::MpscQueue<Job>              mailbox_;             /// stores ports which have work to do
+    std::atomic<bool>                 scheduled_ = {true};  /// true when Actor is scheduled or executing a callback
+    std::atomic<int>                  consuming_ = {0};     /// number of consume() calls not yet returned
+    PortList                          ports_ = {};          /// Actor input ports, port 0 is on the default network
+    std::atomic<CallBackHandle>       handleCounter_ = {0}; /// callback handles are unique among all ports
+    LifeCycleHelper                   lifeCycleHelper_;     /// sticks together the data of the life cycle
+
+    // Budget of the running activation, only touched in actor context.
+    ActivationBudget                      activationBudget_;              /// limits of one consume(), Config by default
+    int                                   activationMessagesLeft_ = 0;     /// messages left in the current activation
+    std::chrono::steady_clock::time_point activationDeadline_     = {};    /// end of the time slice if there is one
+    bool                                  activationExhausted_    = false; /// set when the budget has been used up
+
+    std::vector<std::unique_ptr<SocketReceiver>> receivers_ = {}; /// the sockets of receive(), only touched in actor context
 
     /**
      * Thread local id gets filled by Priority with the currently executing thread id. The main
@@ -377,6 +736,19 @@ private:
      */
     thread_local static int thread_id;
 
+    /**
+     * The actor consuming its mailbox on this thread, nullptr outside of an activation.
+     */
+    thread_local static const Actor* running_;
+
+    /**
+     * @return True when called in the context of this actor.
+     */
+    bool isRunningOnThisThread() const
+    {
+        return running_ == this;
+    }
+
     ActorList  children_ = {};               /// Sorting children by handle
     ActorState state_    = ActorState::INIT; /// state initialized to INIT
 };
@@ -390,6 +762,12 @@ namespace adst::ep::test_engine::core {
 
 template <typename TChild, typename... Args>
 Actor::ChildHandle Actor::newChild(Args&&... args)
+{
+    return newChild<TChild>(priorityLevel_, std::forward<Args>(args)...);
+}
+
+template <typename TChild, typename... Args>
+Actor::ChildHandle Actor::newChild(PriorityLevel level, Args&&... args)
 {
     using PrivStartReq  = StartReq<TChild>;
     using PrivStartCnfT = PrivStartCnf<TChild>;
@@ -398,10 +776,10 @@ Actor::ChildHandle Actor::newChild(Args&&... args)
     static_assert(std::is_base_of<Actor, TChild>::value, "TRootActor must be derived from Actor");
 
     auto handle = newHandle();
-    children_.emplace(handle,
-                      ChildContainer{[this]() { publish(std::make_unique<PrivStartReq>()); },
-                                     [this]() { publish(std::make_unique<PrivStopReq>()); },
-                                     std::make_unique<ActorLifeCycle<TChild>>(env_, std::forward<Args>(args)...)});
+    children_.emplace(
+        handle, ChildContainer{[this]() { publish(std::make_unique<PrivStartReq>()); },
+                               [this]() { publish(std::make_unique<PrivStopReq>()); },
+                               std::make_unique<ActorLifeCycle<TChild>>(level, env_, std::forward<Args>(args)...)});
     // GCOVR_EXCL_START
     listen<PrivStartCnfT>([this](const PrivStartCnfT&) {
         lifeCycleHelper_.childrenCnfCount_++;
@@ -442,77 +820,76 @@ void Actor::listen(CallBackHandle handle, std::function<void(const TMessage&)> c
 {
     if constexpr (std::is_base_of<core::StartCnfHelper, TMessage>::value) {
         if (state_ == ActorState::INIT) { // type id is not yet initialized
-            LOG_C_D("delayed listen:{%s}", impl::getTypeName<TMessage>().c_str());
+            LOG_C_D("delayed listen:{%s}", impl::getTypeName<TMessage>());
             lifeCycleHelper_.delayedListens_.emplace_back([this, handle, callBack]() {
                 // GCOVR_EXCL_START
                 if (impl::type_id<TMessage>() == lifeCycleHelper_.startCnfTypeId_) {
                     // GCOVR_EXCL_STOP
                     lifeCycleHelper_.publicStartCallbackList_.insert(
                         {handle, std::move([this, callBack]() {
-                             LOG_CH_D(MSG_RX, "%s", impl::getTypeName<TMessage>().c_str());
+                             LOG_CH_D(MSG_RX, "%s", impl::getTypeName<TMessage>());
                              callBack(TMessage());
                          })});
                     LOG_C_D("added delayed listener:{%s} to publicStartCallbackList_, size=%d",
-                            impl::getTypeName<TMessage>().c_str(), lifeCycleHelper_.publicStartCallbackList_.size());
+                            impl::getTypeName<TMessage>(), lifeCycleHelper_.publicStartCallbackList_.size());
                 } else {
-                    ports_[0]->listen(handle, std::move(callBack));
+                    ports_[DEFAULT_PORT]->listen(handle, std::move(callBack));
                 }
             });
         } else { // when listen for StartCnf called after constructor
-            LOG_C_D("special listen:{%s}", impl::getTypeName<TMessage>().c_str());
+            LOG_C_D("special listen:{%s}", impl::getTypeName<TMessage>());
             if (impl::type_id<TMessage>() == lifeCycleHelper_.startCnfTypeId_) {
-                LOG_C_D("listen:{%s}, matches local StartCnf", impl::getTypeName<TMessage>().c_str());
+                LOG_C_D("listen:{%s}, matches local StartCnf", impl::getTypeName<TMessage>());
                 lifeCycleHelper_.publicStartCallbackList_.insert({handle, std::move([this, callBack]() {
                                                                       LOG_CH_D(MSG_RX, "%s",
-                                                                               impl::getTypeName<TMessage>().c_str());
+                                                                               impl::getTypeName<TMessage>());
                                                                       callBack(TMessage());
                                                                   })});
                 LOG_C_D("added listener:{%s} to publicStartCallbackList_, size=%d",
-                        impl::getTypeName<TMessage>().c_str(), lifeCycleHelper_.publicStartCallbackList_.size());
+                        impl::getTypeName<TMessage>(), lifeCycleHelper_.publicStartCallbackList_.size());
             } else {
-                ports_[0]->listen(handle, std::move(callBack));
+                ports_[DEFAULT_PORT]->listen(handle, std::move(callBack));
             }
         }
     }
 
     else if constexpr (std::is_base_of<core::StopCnfHelper, TMessage>::value) {
         if (state_ == ActorState::INIT) { // type id is not yet initialized
-            LOG_C_D("delayed listen:{%s}", impl::getTypeName<TMessage>().c_str());
+            LOG_C_D("delayed listen:{%s}", impl::getTypeName<TMessage>());
             lifeCycleHelper_.delayedListens_.emplace_back([this, handle, callBack]() {
                 // GCOVR_EXCL_START
                 if (impl::type_id<TMessage>() == lifeCycleHelper_.stopCnfTypeId_) {
                     // GCOVR_EXCL_STOP
                     lifeCycleHelper_.publicStopCallbackList_.insert(
                         {handle, std::move([this, callBack]() {
-                             LOG_CH_D(MSG_RX, "%s", impl::getTypeName<TMessage>().c_str());
+                             LOG_CH_D(MSG_RX, "%s", impl::getTypeName<TMessage>());
                              callBack(TMessage());
                          })});
                     LOG_C_D("added delayed listener:{%s} to publicStopCallbackList_, size=%d",
-                            impl::getTypeName<TMessage>().c_str(), lifeCycleHelper_.publicStopCallbackList_.size());
+                            impl::getTypeName<TMessage>(), lifeCycleHelper_.publicStopCallbackList_.size());
                 } else {
-                    ports_[0]->listen(handle, std::move(callBack));
+                    ports_[DEFAULT_PORT]->listen(handle, std::move(callBack));
                 }
             });
         } else {
-            LOG_C_D("special listen:{%s}", impl::getTypeName<TMessage>().c_str());
+            LOG_C_D("special listen:{%s}", impl::getTypeName<TMessage>());
             if (impl::type_id<TMessage>() == lifeCycleHelper_.stopCnfTypeId_) {
-                LOG_C_D("listen:{%s}, matches local StopCnf", impl::getTypeName<TMessage>().c_str());
+                LOG_C_D("listen:{%s}, matches local StopCnf", impl::getTypeName<TMessage>());
                 lifeCycleHelper_.publicStopCallbackList_.insert({handle, std::move([this, callBack]() {
                                                                      LOG_CH_D(MSG_RX, "%s",
-                                                                              impl::getTypeName<TMessage>().c_str());
+                                                                              impl::getTypeName<TMessage>());
                                                                      callBack(TMessage());
                                                                  })});
                 LOG_C_D("added listener:{%s} to publicStopCallbackList_, size=%d",
-                        impl::getTypeName<TMessage>().c_str(), lifeCycleHelper_.publicStopCallbackList_.size());
+                        impl::getTypeName<TMessage>(), lifeCycleHelper_.publicStopCallbackList_.size());
             } else {
-                ports_[0]->listen(handle, std::move(callBack));
+                ports_[DEFAULT_PORT]->listen(handle, std::move(callBack));
             }
         }
     }
 
     else {
-        // for now we only have 1 port.
-        ports_[0]->listen(handle, std::move(callBack));
+        ports_[DEFAULT_PORT]->listen(handle, std::move(callBack));
     }
 }
 
@@ -526,16 +903,14 @@ CallBackHandle Actor::listen(std::function<void(const TMessage&)> callBack)
         return newHandle;
     }
 
-    // for now we only have 1 port.
-    return ports_[0]->listen(std::move(callBack));
+    return ports_[DEFAULT_PORT]->listen(std::move(callBack));
 }
 
 template <typename TMessage>
 void Actor::unlisten(CallBackHandle handle)
 {
-    // for now we only have 1 port.
     if constexpr (std::is_base_of<core::StartCnfHelper, TMessage>::value) {
-        LOG_C_D("special unlisten:{%s}", impl::getTypeName<TMessage>().c_str());
+        LOG_C_D("special unlisten:{%s}", impl::getTypeName<TMessage>());
         if (impl::type_id<TMessage>() == lifeCycleHelper_.startCnfTypeId_) {
             lifeCycleHelper_.publicStartCallbackList_.erase(handle);
             return;
@@ -543,13 +918,53 @@ void Actor::unlisten(CallBackHandle handle)
     }
 
     if constexpr (std::is_base_of<core::StopCnfHelper, TMessage>::value) {
-        LOG_C_D("special unlisten:{%s}", impl::getTypeName<TMessage>().c_str());
+        LOG_C_D("special unlisten:{%s}", impl::getTypeName<TMessage>());
         if (impl::type_id<TMessage>() == lifeCycleHelper_.stopCnfTypeId_) {
             lifeCycleHelper_.publicStopCallbackList_.erase(handle);
             return;
         } // else we return to the default unlisten
     }
-    ports_[0]->unlisten<TMessage>(handle);
+    ports_[DEFAULT_PORT]->unlisten<TMessage>(handle);
+}
+
+template <typename TMessage>
+void Actor::publishOn(PortIndex port, std::unique_ptr<TMessage> msg)
+{
+    checkPublish<TMessage>();
+    ports_[port]->getNetwork().publish(std::move(msg));
+}
+
+template <typename TMessage>
+void Actor::publishOn(PortIndex port, std::shared_ptr<TMessage> msg)
+{
+    checkPublish<TMessage>();
+    ports_[port]->getNetwork().publish(std::move(msg));
+}
+
+template <typename TMessage>
+CallBackHandle Actor::listenOn(PortIndex port, std::function<void(const TMessage&)> callBack)
+{
+    return ports_[port]->listen(std::move(callBack));
+}
+
+template <typename TMessage>
+CallBackHandle Actor::listenLatest(std::function<void(const TMessage&)>          callBack,
+                                   std::function<ConflationKey(const TMessage&)> keyOf, PortIndex port)
+{
+    return ports_[port]->listenLatest(std::move(callBack), std::move(keyOf));
+}
+
+template <typename TMessage>
+void Actor::unlistenOn(PortIndex port, CallBackHandle handle)
+{
+    ports_[port]->unlisten<TMessage>(handle);
+}
+
+template <typename TMessage>
+CallBackHandle Actor::forward(PortIndex from, PortIndex to)
+{
+    return listenOn<TMessage>(from,
+                              [this, to](const TMessage& msg) { publishOn(to, std::make_unique<TMessage>(msg)); });
 }
 
 } // namespace adst::ep::test_engine::core
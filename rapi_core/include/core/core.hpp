@@ -49,7 +49,8 @@ public:
         using PrivStopCnf  = Actor::PrivStopCnf<TRootActor>;
         using PrivStartReq = StartReq<TRootActor>;
 
-        root_         = std::make_unique<ActorLifeCycle<TRootActor>>(env_, std::forward<Args>(args)...);
+        root_         = std::make_unique<ActorLifeCycle<TRootActor>>(PriorityLevel::NORMAL, env_,
+                                                                     std::forward<Args>(args)...);
         sendStartReq_ = [this]() { env_.network_.publish(std::make_unique<PrivStartReq>()); };
 
         root_->listen<Stop>([this](const Stop&) {
@@ -77,7 +78,23 @@ public:
         return env_;
     }
 
+    /**
+     * Metrics of every actor and message type it received, enabled by `metrics/enabled` in the config.
+     * Can be called from any thread while the core is running.
+     *
+     * @return One entry per actor and message type, empty when metrics are disabled.
+     */
+    MetricsSnapshot getMetrics() const
+    {
+        return env_.collectMetrics();
+    }
+
 private:
+    /**
+     * Logs a line per actor and message type on the core channel.
+     */
+    void logMetrics();
+
     const Environment env_;       /// Shared environment for all actors.
     Actor::ActorPtr   root_ = {}; /// The root actor created by init(..).
     // this is a cumbersome ugly pattern what std::threads forcing on you to create and use a
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
 namespace adst::ep::test_engine::core {
 
 /**
@@ -8,4 +13,68 @@ namespace adst::ep::test_engine::core {
  */
 using CallBackHandle = int;
 
+/**
+ * Events with the same key replace each other in a conflating listen, see Actor::listenLatest().
+ */
+using ConflationKey = std::uint64_t;
+
+/**
+ * Each actor is executed by the priority of its level. A level configured with its own dispatchers
+ * is not delayed by the actors of the other levels, otherwise it shares the dispatchers of NORMAL.
+ */
+enum class PriorityLevel
+{
+    HIGH,   /// control plane e.g. service discovery
+    NORMAL, /// default level of actors
+    LOW,    /// bulk traffic
+};
+
+constexpr std::size_t PRIORITY_LEVEL_COUNT = 3; /// number of PriorityLevel values
+
+/**
+ * What a port does with a new event when its queue is full.
+ */
+enum class OverloadPolicy
+{
+    DROP_OLDEST, /// the oldest queued event of the port is dropped
+    DROP_NEWEST, /// the new event is dropped
+    KEEP_LATEST, /// the new event replaces the newest queued event of its type, else like DROP_OLDEST
+    BLOCK,       /// the publisher waits till the port has room, except the owner publishing to itself
+};
+
+/**
+ * Limits the events queued on a port.
+ */
+struct PortLimit
+{
+    std::size_t    capacity_ = 0;                           /// events queued at most, 0 means no limit
+    OverloadPolicy policy_   = OverloadPolicy::DROP_OLDEST; /// applied when capacity_ is reached
+};
+
+/**
+ * How the dispatchers of a priority wait for socket I/O, see Actor::receive().
+ */
+enum class IoBackend
+{
+    NONE,     /// no socket I/O, the dispatchers sleep on a condition variable
+    EPOLL,    /// epoll and recvmmsg, works on any linux kernel
+    IO_URING, /// multishot recvmsg into provided buffers, falls back to EPOLL if the kernel lacks support
+};
+
+/**
+ * A datagram received by the I/O engine of a dispatcher. The bytes stay in the receive buffer of the
+ * engine, they are only valid in the callback they were handed to.
+ */
+struct IoDatagram
+{
+    const std::uint8_t* data_        = nullptr; /// the payload
+    std::size_t         size_        = 0;       /// bytes of the payload in data_
+    std::uint32_t       peerAddress_ = 0;       /// IPv4 address of the sender, host byte order
+    std::uint16_t       peerPort_    = 0;       /// port of the sender, host byte order
+    bool                truncated_   = false;   /// the datagram did not fit into the receive buffer
+};
+
+using IoDatagrams     = std::vector<IoDatagram>;                  /// datagrams of one wake-up of the engine
+using ReceiveCallBack = std::function<void(const IoDatagrams&)>; /// called in actor context, see Actor::receive()
+
 } // namespace adst::ep::test_engine::core
@@ -1,9 +1,19 @@
 #pragma once
 
 #include <core/network.hpp>
+#include <array>
+#include <chrono>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 #include "adstutil_cxx/error_handler.hpp"
 #include "config_cxx/config_and_logger.hpp"
+#include "core/core_types.hpp"
+#include "core/impl/message_metrics.hpp"
+#include "core/metrics.hpp"
 #include "core/priority.hpp"
 
 using adst::common::ConfigAndLogger;
@@ -13,6 +23,7 @@ namespace adst::ep::test_engine::core {
 
 class Core;
 class Actor;
+class Port;
 
 /**
  * A shared single read-only instance of an environment used by the core. It is passed to all actors.
@@ -36,23 +47,34 @@ public:
      */
     const ConfigAndLogger& configAndLogger_;
 
+    /**
+     * Name of the network carrying the life cycle, used by the actor functions without a port index.
+     */
+    static constexpr const char* DEFAULT_NETWORK = "";
+
+    /**
+     * Actors may use it to watch the system, the same as Core::getMetrics().
+     * @return The metrics of all ports, empty when metrics are disabled.
+     */
+    MetricsSnapshot collectMetrics() const;
+
 #ifdef ADST_CORE_TEST_ENABLED
     /**
      * Only required by (and used for) tests.
      * @return
      */
-    Priority& getPrioForTest() const
+    Priority& getPrioForTest(PriorityLevel level = PriorityLevel::NORMAL) const
     {
-        return priority_;
+        return getPriority(level);
     }
 
     /**
      * Only required by (and used for) tests.
      * @return
      */
-    Network& getNetworkForTest() const
+    Network& getNetworkForTest(const std::string& name = DEFAULT_NETWORK) const
     {
-        return network_;
+        return getNetwork(name);
     }
 #endif
 
@@ -61,12 +83,81 @@ public:
 private:
     friend Core;
     friend Actor;
+    friend Port;
+    /**
+     * @param level The priority level of an actor.
+     * @return The priority executing the actors of the level.
+     */
+    Priority& getPriority(PriorityLevel level) const
+    {
+        return *levelToPriority_[static_cast<std::size_t>(level)];
+    }
+
+    /**
+     * Networks are isolated from each other, each has its own subscriber tables and locks. A message
+     * published to a network is only delivered to the ports attached to it.
+     * @param name Name of the network, it is created when the name is used the first time.
+     * @return The network, it lives as long as the environment.
+     */
+    Network& getNetwork(const std::string& name) const;
+
+    /**
+     * Starts the dispatchers of all priorities.
+     */
+    void startPriorities() const;
+
+    /**
+     * Blocks until all priorities are idle at the same time. An actor of one priority can schedule
+     * an actor of an other one, so waiting for each priority once is not enough.
+     */
+    void waitForIdle() const;
+
+    /**
+     * Stops all priorities, shall be called when all of them are idle.
+     */
+    void stopPriorities() const;
+
+    /**
+     * Creates the metrics of a message type received by an actor, called when the port of the actor
+     * sees the type the first time. The metrics outlive the actor, so collectMetrics() keeps
+     * reporting the last values of destroyed actors.
+     * @param actor Name of the actor.
+     * @param type Name of the message type.
+     * @return The counters updated by the port, nullptr when metrics are disabled.
+     */
+    std::shared_ptr<impl::MessageCounters> newMessageCounters(const std::string& actor, const char* type) const;
+
+    /**
+     * One priority per level configured with own dispatchers, the normal level is always the first.
+     */
+    std::vector<std::unique_ptr<Priority>> priorities_ = {};
+    /// the priority of each level, levels without own dispatchers point to the normal priority
+    std::array<Priority*, PRIORITY_LEVEL_COUNT> levelToPriority_ = {};
+
+    mutable Network network_ = Network{}; /// The default network, carries the life cycle of all actors.
+
+    mutable std::mutex                                      networksMutex_; /// guard for networks_
+    mutable std::map<std::string, std::unique_ptr<Network>> networks_ = {}; /// the other networks by name
+
+    std::string flowTraceFile_ = {}; /// the flow trace is dumped to this file when the core stops, empty for none
+
+    PortLimit portLimit_ = {}; /// the limit of new ports, from the ports section of the config
+
+    bool                             metricsEnabled_   = false; /// ports measure queue depth, latency and service time
+    std::chrono::milliseconds        metricsLogPeriod_ = {};    /// period of the metrics log of the core, 0 for none
+
     /**
-     * For now a single level of priority defined for ADST core all actors are executed in this priority level.
+     * The metrics of a message type received by an actor.
      */
-    mutable Priority priority_ =
-        Priority(configAndLogger_.config_.numberOfDispatchers_, configAndLogger_.config_.onErrorCallBack_);
-    mutable Network network_ = Network{}; /// The only single network used by all Actors.
+    struct MetricsEntry
+    {
+        std::string                            actor_;
+        const char*                            type_;
+        std::shared_ptr<impl::MessageCounters> counters_;
+    };
+
+    mutable std::mutex                metricsMutex_;   /// guard for metrics_
+    mutable std::vector<MetricsEntry> metrics_ = {}; /// all counters handed out, for collectMetrics()
 };
 
 } // namespace adst::ep::test_engine::core
@@ -33,12 +33,16 @@ public:
     /**
      * The constructor registers the actor to the network via listen-publish methods.
      *
+     * @param level The priority level executing the actor.
      * @param env Environment provided by the core.
      */
     template <typename... Args>
-    ActorLifeCycle(const Environment& env, Args&&... args)
+    ActorLifeCycle(PriorityLevel level, const Environment& env, Args&&... args)
         : TActor(env, std::forward<Args>(args)...)
     {
+        // the actor is not posted on any priority before ctorFinished()
+        TActor::setPriorityLevel(level);
+
         TActor::lifeCycleHelper_.publishPrivStartCnf_ = [this]() { TActor::publish(std::make_unique<PrivStartCnf>()); };
         TActor::lifeCycleHelper_.publishPrivStopCnf_  = [this]() { TActor::publish(std::make_unique<PrivStopCnf>()); };
         TActor::lifeCycleHelper_.publishPubStartCnf_  = [this]() { TActor::publish(std::make_unique<PubStartCnf>()); };
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <utility>
 #include <vector>
 
 #include "call_back_vector.hpp"
@@ -9,14 +10,15 @@
 namespace adst::ep::test_engine::core::impl {
 
 /**
- * Implements an iterable container for callbacks.
+ * Implements an iterable container for callbacks. The callbacks are stored in a flat vector in the
+ * order of registration, so they are also called in that order.
  * @tparam Event Common event type which is used in the callback as input parameter.
  */
 template <typename Event>
 struct AsyncCallbackVector : public CallbackVector
 {
-    using CallbackType = std::function<void(const Event&)>;      /// Prototype of the callback.
-    std::unordered_map<CallBackHandle, CallbackType> container_; /// Each callback is uniquely identified by a handle.
+    using CallbackType = std::function<void(const Event&)>;           /// Prototype of the callback.
+    std::vector<std::pair<CallBackHandle, CallbackType>> container_; /// Each callback is uniquely identified by a handle.
 
     /**
      * Removes the callback function from the store.
@@ -25,7 +27,10 @@ struct AsyncCallbackVector : public CallbackVector
      */
     virtual bool remove(const CallBackHandle handle) override
     {
-        container_.erase(handle);
+        auto found = find(handle);
+        if (found != container_.end()) {
+            container_.erase(found);
+        }
         return container_.empty();
     }
 
@@ -36,7 +41,19 @@ struct AsyncCallbackVector : public CallbackVector
      */
     void add(const CallBackHandle handle, CallbackType callback)
     {
-        container_[handle] = std::move(callback);
+        auto found = find(handle);
+        if (found != container_.end()) {
+            found->second = std::move(callback);
+        } else {
+            container_.emplace_back(handle, std::move(callback));
+        }
+    }
+
+private:
+    auto find(const CallBackHandle handle)
+    {
+        return std::find_if(container_.begin(), container_.end(),
+                            [handle](const auto& element) { return element.first == handle; });
     }
 };
 
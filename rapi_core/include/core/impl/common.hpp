@@ -4,6 +4,7 @@
 #include <type_traits>
 
 #include "adstutil_cxx/type_id.hpp"
+#include "adstutil_cxx/type_index.hpp"
 
 namespace adst::ep::test_engine::core::impl {
 
@@ -15,12 +16,12 @@ namespace adst::ep::test_engine::core::impl {
  * require a static NAME member).
  *
  * @tparam EventT The event (or message) type to use.
- * @return String containing the types name.
+ * @return The types name, points into the static NAME so nothing is copied.
  */
 template <typename EventT>
-const std::string getTypeName()
+const char* getTypeName()
 {
-   return EventT::NAME.c_str();
+    return EventT::NAME.c_str();
 }
 
 /**
@@ -39,6 +40,45 @@ type_id_t type_id()
     return adst::common::type_id<T>();
 }
 
+/**
+ * Internal alias for the dense type index, used to index the per event type tables.
+ */
+using type_index_t = adst::common::type_index_t;
+
+/**
+ * Helper for getting the dense "type index".
+ * @tparam T Input type for index creation.
+ * @return A small unique number for input type T, usable as vector index.
+ */
+template <typename T>
+type_index_t type_index()
+{
+    return adst::common::type_index<T>();
+}
+
+/**
+ * Messages declaring `static constexpr bool URGENT = true;` are dispatched by the receiving port
+ * before the other messages it has queued.
+ */
+template <typename Event, typename = void>
+struct IsUrgent : public std::false_type
+{
+};
+
+template <typename Event>
+struct IsUrgent<Event, std::void_t<decltype(Event::URGENT)>> : public std::bool_constant<Event::URGENT>
+{
+};
+
+/**
+ * @return True when Event carries the urgency hint.
+ */
+template <class Event>
+constexpr bool isUrgent()
+{
+    return IsUrgent<Event>::value;
+}
+
 /**
  * Verify that the type used as Event fulfills the necessary requirements to be used as Event.
  */
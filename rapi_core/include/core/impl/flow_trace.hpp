@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "core/impl/common.hpp"
+
+namespace adst::ep::test_engine::core::impl {
+
+/**
+ * The steps of the message flow recorded by FlowTrace.
+ */
+enum class FlowEvent : std::uint8_t
+{
+    PUBLISH,        /// the actor published the message
+    QUEUE,          /// the message was queued on the port of the actor
+    DISPATCH_BEGIN, /// the actor starts calling its listeners of the message
+    DISPATCH_END,   /// the listeners of the actor returned
+};
+
+/**
+ * One entry of the flow trace, written as is to the trace file.
+ */
+struct FlowRecord
+{
+    std::uint64_t timestamp_; /// steady clock in nanoseconds
+    type_index_t  typeIndex_; /// the message type, see type_index()
+    std::uint32_t actorId_;   /// see FlowTrace::registerActor()
+    FlowEvent     event_;     /// what happened with the message
+};
+
+/**
+ * Binary trace of the message flow which is cheap enough to stay enabled in production.
+ *
+ * Each thread records into its own ring, so recording is a handful of stores and a release store of
+ * the ring head, without a lock, a format string or an allocation. The rings keep the newest records
+ * only. Nothing is decoded while running: dump() writes the raw records together with the names of
+ * the types and actors, decodeText() and decodeChromeTrace() (and the RapiFlowTraceDecode tool) turn
+ * the dump into something readable offline.
+ *
+ * The trace is off until enable() is called, a disabled trace costs one relaxed load per record().
+ */
+class FlowTrace
+{
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 16384; /// records kept per thread by default
+
+    /**
+     * Starts recording, the rings of threads which have not recorded yet get the given capacity.
+     * @param capacity Records kept per thread, rounded up to a power of two.
+     */
+    static void enable(std::size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Stops recording, the records already taken are kept for dump().
+     */
+    static void disable();
+
+    /**
+     * @return True while recording.
+     */
+    static bool isEnabled()
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Hands out the id identifying an actor in the records.
+     * @param name Name of the actor shown by the decoder.
+     * @return A process wide unique id.
+     */
+    static std::uint32_t registerActor(const std::string& name);
+
+    /**
+     * Records a step of the message flow on the ring of the calling thread.
+     * @tparam EventT The message type.
+     * @param event What happened with the message.
+     * @param actorId The actor publishing or receiving the message.
+     */
+    template <typename EventT>
+    static void record(FlowEvent event, std::uint32_t actorId)
+    {
+        if (isEnabled()) {
+            // the name is registered once per type, the hot path only checks the guard of the static
+            static const bool named = registerType(type_index<EventT>(), getTypeName<EventT>());
+            (void)named;
+            write({timestamp(), type_index<EventT>(), actorId, event});
+        }
+    }
+
+    /**
+     * Writes the rings of all threads, the oldest record first, and the names needed to decode them.
+     * Threads may keep recording meanwhile, the records overwritten during the dump are skipped.
+     * @param out Binary stream receiving the dump.
+     */
+    static void dump(std::ostream& out);
+
+    /**
+     * Same as dump(std::ostream&) to a file.
+     * @param fileName The file to create.
+     * @return False when the file could not be written.
+     */
+    static bool dump(const std::string& fileName);
+
+    /**
+     * Prints the records of a dump one per line, ordered by time.
+     * @param in Binary stream holding a dump.
+     * @param out Receives the text.
+     * @return False when in is not a valid dump.
+     */
+    static bool decodeText(std::istream& in, std::ostream& out);
+
+    /**
+     * Converts a dump to the Chrome trace event format (chrome://tracing, Perfetto). Dispatches are
+     * shown as slices of the dispatcher thread, publish and queue as instant events.
+     * @param in Binary stream holding a dump.
+     * @param out Receives the JSON.
+     * @return False when in is not a valid dump.
+     */
+    static bool decodeChromeTrace(std::istream& in, std::ostream& out);
+
+private:
+    static std::uint64_t timestamp()
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::steady_clock::now().time_since_epoch())
+                                              .count());
+    }
+
+    static bool registerType(type_index_t typeIndex, const char* name);
+
+    static void write(const FlowRecord& record);
+
+    static std::atomic<bool> enabled_; /// recording is on
+};
+
+} // namespace adst::ep::test_engine::core::impl
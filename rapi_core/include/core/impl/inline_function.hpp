@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace adst::ep::test_engine::core::impl {
+
+template <typename Signature, std::size_t Capacity = 56>
+class InlineFunction;
+
+/**
+ * Move only replacement of std::function which never allocates. The callable is always stored in
+ * the internal buffer, a callable (e.g. a lambda with too many captures) which does not fit is a
+ * compile time error.
+ *
+ * The default capacity makes the whole object 64 bytes (one cache line) which is enough for `this`
+ * plus a shared_ptr or a std::function.
+ *
+ * @tparam R Return type of the call.
+ * @tparam Args Argument types of the call.
+ * @tparam Capacity Size of the inline buffer in bytes.
+ */
+template <typename R, typename... Args, std::size_t Capacity>
+class InlineFunction<R(Args...), Capacity>
+{
+    template <typename F>
+    using EnableIfCallable =
+        std::enable_if_t<!std::is_same<std::decay_t<F>, InlineFunction>::value &&
+                             std::is_invocable_r<R, std::decay_t<F>&, Args...>::value,
+                         int>;
+
+public:
+    InlineFunction() noexcept = default;
+
+    InlineFunction(std::nullptr_t) noexcept // NOLINT(google-explicit-constructor) same as std::function
+    {
+    }
+
+    /**
+     * Stores the callable in the inline buffer.
+     * @tparam F Type of the callable.
+     * @param callable The callable to store, it is moved or copied into the buffer.
+     */
+    template <typename F, EnableIfCallable<F> = 0>
+    InlineFunction(F&& callable) // NOLINT(google-explicit-constructor) implicit like std::function
+    {
+        using Callable = std::decay_t<F>;
+        static_assert(sizeof(Callable) <= Capacity, "callable does not fit into InlineFunction, capture less");
+        static_assert(alignof(Callable) <= alignof(std::max_align_t), "callable alignment is not supported");
+        static_assert(std::is_nothrow_move_constructible<Callable>::value, "callable must be nothrow movable");
+        ::new (static_cast<void*>(&storage_)) Callable(std::forward<F>(callable));
+        ops_ = &OPS<Callable>;
+    }
+
+    InlineFunction(InlineFunction&& other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    InlineFunction& operator=(InlineFunction&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    InlineFunction& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    // not copyable, the captures might not be copyable
+    InlineFunction(const InlineFunction&) = delete;
+    InlineFunction& operator=(const InlineFunction&) = delete;
+
+    ~InlineFunction()
+    {
+        reset();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ops_ != nullptr;
+    }
+
+    /**
+     * Calls the stored callable. Shall not be called on an empty object.
+     */
+    R operator()(Args... args) const
+    {
+        return ops_->invoke(&storage_, std::forward<Args>(args)...);
+    }
+
+private:
+    /**
+     * Type erased operations of the stored callable.
+     */
+    struct Ops
+    {
+        R (*invoke)(void* storage, Args&&... args);  /// calls the callable
+        void (*move)(void* destination, void* source); /// move constructs destination and destroys source
+        void (*destroy)(void* storage);                /// destroys the callable
+    };
+
+    template <typename Callable>
+    static constexpr Ops OPS = {
+        [](void* storage, Args&&... args) -> R {
+            return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...);
+        },
+        [](void* destination, void* source) {
+            ::new (destination) Callable(std::move(*static_cast<Callable*>(source)));
+            static_cast<Callable*>(source)->~Callable();
+        },
+        [](void* storage) { static_cast<Callable*>(storage)->~Callable(); },
+    };
+
+    void moveFrom(InlineFunction& other) noexcept
+    {
+        if (other.ops_ != nullptr) {
+            other.ops_->move(&storage_, &other.storage_);
+            ops_       = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    void reset() noexcept
+    {
+        if (ops_ != nullptr) {
+            ops_->destroy(&storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    using Storage = std::aligned_storage_t<Capacity, alignof(std::max_align_t)>;
+
+    mutable Storage storage_;        /// the callable lives here, mutable to be callable like std::function
+    const Ops*      ops_ = nullptr; /// operations of the stored callable, nullptr when empty
+};
+
+} // namespace adst::ep::test_engine::core::impl
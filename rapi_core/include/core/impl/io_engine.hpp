@@ -0,0 +1,125 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "adstutil_cxx/error_handler.hpp"
+#include "core/core_types.hpp"
+
+namespace adst::ep::test_engine::core::impl {
+
+/**
+ * A socket registered on an IoEngine. It is owned by the engine, the one who added it keeps a
+ * reference till it removes it.
+ */
+struct IoReceiver
+{
+    using OnBatch = std::function<void(IoReceiver&)>;
+
+    IoReceiver(int fd, OnBatch onBatch)
+        : fd_(fd)
+        , onBatch_(std::move(onBatch))
+    {
+    }
+
+    // not copyable or movable, the engines keep pointers to their receivers in the kernel
+    IoReceiver(const IoReceiver&) = delete;
+    IoReceiver(IoReceiver&&)      = delete;
+
+    IoReceiver& operator=(const IoReceiver&) = delete;
+    IoReceiver& operator=(IoReceiver&&) = delete;
+
+    virtual ~IoReceiver() = default;
+
+    const int   fd_;                /// the socket
+    OnBatch     onBatch_;           /// told when datagrams_ is ready, empty after the receiver was removed
+    IoDatagrams datagrams_ = {};    /// the batch handed out by onBatch_, valid till release()
+    bool        held_      = false; /// datagrams_ was handed out and is not yet released
+};
+
+/**
+ * Socket I/O of one dispatcher, so actors receive without threads of their own and the dispatcher
+ * sleeps in the engine instead of on the condition variable of the priority.
+ *
+ * Apart from wake() the engine is only used by the thread of its dispatcher: poll() by the dispatcher
+ * loop, the receivers by the actors bound to the dispatcher. A receiver has at most one batch handed
+ * out, the socket is not read into the receiver again before the batch is released. Datagrams
+ * arriving in the meantime wait in the kernel (or, with io_uring, in the buffers already filled), so a
+ * slow actor throttles its own socket without holding up the others.
+ */
+class IoEngine
+{
+public:
+    IoEngine() = default;
+
+    // not copyable or movable
+    IoEngine(const IoEngine&) = delete;
+    IoEngine(IoEngine&&)      = delete;
+
+    IoEngine& operator=(const IoEngine&) = delete;
+    IoEngine& operator=(IoEngine&&) = delete;
+
+    virtual ~IoEngine() = default;
+
+    /**
+     * Creates the engine of a dispatcher, shall be called by the dispatcher thread (io_uring binds the
+     * ring to its creator).
+     * @param backend The backend asked for, IO_URING falls back to EPOLL if the ring cannot be set up.
+     * @param bufferCount Receive buffers of the engine (io_uring) or of each receiver (epoll).
+     * @param bufferSize Bytes per receive buffer.
+     * @param onError Error callback of the config.
+     * @param report Set to what has been created, e.g. " io=io_uring".
+     * @return The engine.
+     */
+    static std::unique_ptr<IoEngine> create(IoBackend backend, int bufferCount, int bufferSize,
+                                            const adst::common::OnErrorCallBack& onError, std::string& report);
+
+    /**
+     * Starts receiving from a socket.
+     * @param fd The socket, the caller keeps owning it.
+     * @param onBatch Called by poll() or release() when datagrams are ready, the batch is held till release().
+     * @return The receiver, valid till removeReceiver().
+     */
+    virtual IoReceiver& addReceiver(int fd, IoReceiver::OnBatch onBatch) = 0;
+
+    /**
+     * Stops receiving, a batch still handed out is released as well. The socket can be closed
+     * afterwards, the engine cancels what is still in flight.
+     * @param receiver A receiver of this engine.
+     */
+    virtual void removeReceiver(IoReceiver& receiver) = 0;
+
+    /**
+     * Gives the buffers of the handed out batch back. Datagrams which arrived in the meantime are
+     * handed out right away.
+     * @param receiver A receiver of this engine holding a batch.
+     */
+    virtual void release(IoReceiver& receiver) = 0;
+
+    /**
+     * Submits what is pending and hands out the batches of the completions.
+     * @param wait Blocks till there is a completion or wake() has been called.
+     * @return True when something completed.
+     */
+    virtual bool poll(bool wait) = 0;
+
+    /**
+     * Makes a blocking poll() return, or the next one if none is blocking. Can be called from any thread.
+     */
+    virtual void wake() = 0;
+};
+
+/**
+ * @return An epoll engine, nullptr if epoll cannot be set up, reason holds why.
+ */
+std::unique_ptr<IoEngine> makeEpollEngine(int bufferCount, int bufferSize, const adst::common::OnErrorCallBack& onError,
+                                          std::string& reason);
+
+/**
+ * @return An io_uring engine, nullptr if the kernel does not support what is needed, reason holds why.
+ */
+std::unique_ptr<IoEngine> makeIoUringEngine(int bufferCount, int bufferSize,
+                                            const adst::common::OnErrorCallBack& onError, std::string& reason);
+
+} // namespace adst::ep::test_engine::core::impl
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "core/metrics.hpp"
+
+namespace adst::ep::test_engine::core::impl {
+
+/**
+ * Latency histogram which can be recorded from any thread without a lock, see LatencySnapshot for
+ * the buckets.
+ */
+class LatencyHistogram
+{
+public:
+    /**
+     * @param duration The latency to count.
+     */
+    void record(std::chrono::steady_clock::duration duration)
+    {
+        const auto value = static_cast<std::uint64_t>(
+            std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), 0));
+        buckets_[LatencySnapshot::bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        auto max = max_.load(std::memory_order_relaxed);
+        while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * The samples recorded meanwhile may be partly included.
+     * @return Copy of the histogram.
+     */
+    LatencySnapshot snapshot() const
+    {
+        LatencySnapshot snapshot;
+        snapshot.buckets_.reserve(buckets_.size());
+        for (const auto& bucket : buckets_) {
+            snapshot.buckets_.push_back(bucket.load(std::memory_order_relaxed));
+            snapshot.count_ += snapshot.buckets_.back();
+        }
+        snapshot.sum_ = sum_.load(std::memory_order_relaxed);
+        snapshot.max_ = max_.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, LatencySnapshot::BUCKET_COUNT> buckets_ = {};
+    std::atomic<std::uint64_t>                                            sum_     = {0};
+    std::atomic<std::uint64_t>                                            max_     = {0};
+};
+
+/**
+ * Counters and histograms of one message type on one port. Updated by the publishers and by the
+ * dispatcher of the actor, read by MetricsSnapshot collection, all without a lock.
+ */
+struct MessageCounters
+{
+    /**
+     * Counts a queued message.
+     * @param depth Messages of the type waiting, including this one.
+     */
+    void queued(std::size_t depth)
+    {
+        queued_.fetch_add(1, std::memory_order_relaxed);
+        auto max = maxQueueDepth_.load(std::memory_order_relaxed);
+        while (depth > max && !maxQueueDepth_.compare_exchange_weak(max, depth, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * Counts a message dropped or replaced by the overload policy of the port.
+     */
+    void dropped()
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Counts a queued message replaced by a newer one of a conflating listen.
+     */
+    void conflated()
+    {
+        conflated_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Counts a dispatched message.
+     * @param queuedAt When the message was queued.
+     * @param start When the dispatch started.
+     * @param end When the listeners returned.
+     */
+    void dispatched(std::chrono::steady_clock::time_point queuedAt, std::chrono::steady_clock::time_point start,
+                    std::chrono::steady_clock::time_point end)
+    {
+        dispatched_.fetch_add(1, std::memory_order_relaxed);
+        latency_.record(start - queuedAt);
+        service_.record(end - start);
+    }
+
+    /**
+     * @param actor Name of the actor owning the port.
+     * @param type Name of the message type.
+     * @return Copy of the counters.
+     */
+    MessageMetrics snapshot(const std::string& actor, const char* type) const
+    {
+        return {actor,
+                type,
+                queued_.load(std::memory_order_relaxed),
+                dispatched_.load(std::memory_order_relaxed),
+                maxQueueDepth_.load(std::memory_order_relaxed),
+                dropped_.load(std::memory_order_relaxed),
+                conflated_.load(std::memory_order_relaxed),
+                latency_.snapshot(),
+                service_.snapshot()};
+    }
+
+    std::atomic<std::uint64_t> queued_        = {0};
+    std::atomic<std::uint64_t> dispatched_    = {0};
+    std::atomic<std::size_t>   maxQueueDepth_ = {0};
+    std::atomic<std::uint64_t> dropped_       = {0};
+    std::atomic<std::uint64_t> conflated_     = {0};
+    LatencyHistogram           latency_;
+    LatencyHistogram           service_;
+};
+
+} // namespace adst::ep::test_engine::core::impl
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+
+namespace adst::ep::test_engine::core::impl {
+
+/**
+ * Recycles memory blocks of a single size and alignment.
+ *
+ * Freed blocks go to a small cache of the freeing thread. When a cache grows too large half of it is
+ * handed to a shared list, a thread with an empty cache takes a batch from there. So the mutex is
+ * only taken once per batch, even if messages are always allocated on one thread and released on an
+ * other. Blocks are never given back to the heap, the pool keeps the high-water mark of the messages
+ * in flight plus the blocks kept in the caches (at most CACHE_SIZE + 1 per thread).
+ *
+ * @tparam SIZE Size of a block.
+ * @tparam ALIGN Alignment of a block.
+ */
+template <std::size_t SIZE, std::size_t ALIGN>
+class BlockPool
+{
+public:
+    BlockPool() = delete;
+
+    /**
+     * @return A block of SIZE bytes, from the pool if there is one, from the heap otherwise.
+     */
+    static void* allocate()
+    {
+        if (isCacheGone()) {
+            return newBlock();
+        }
+        Cache& cache = getCache();
+        if (cache.head_ == nullptr) {
+            Shared&                     shared = getShared();
+            std::lock_guard<std::mutex> sharedGuard{shared.mutex_};
+            for (int count = 0; count < CACHE_SIZE / 2 && shared.head_ != nullptr; ++count) {
+                FreeBlock* block = shared.head_;
+                shared.head_     = block->next_;
+                cache.push(block);
+            }
+        }
+        if (cache.head_ == nullptr) {
+            return newBlock();
+        }
+        return cache.pop();
+    }
+
+    /**
+     * Gives a block back to the pool. Can be called from any thread.
+     * @param memory A block returned by allocate().
+     */
+    static void deallocate(void* memory)
+    {
+        if (isCacheGone()) {
+            // released by a thread local destructor which ran after the one of the cache
+            Shared&                     shared = getShared();
+            std::lock_guard<std::mutex> sharedGuard{shared.mutex_};
+            auto*                       block = static_cast<FreeBlock*>(memory);
+            block->next_                      = shared.head_;
+            shared.head_                      = block;
+            return;
+        }
+        Cache& cache = getCache();
+        cache.push(static_cast<FreeBlock*>(memory));
+        if (cache.count_ > CACHE_SIZE) {
+            cache.spill(CACHE_SIZE / 2);
+        }
+    }
+
+private:
+    /**
+     * A free block is linked into the lists through its own memory.
+     */
+    struct FreeBlock
+    {
+        FreeBlock* next_;
+    };
+
+    static constexpr std::size_t BLOCK_SIZE  = std::max(SIZE, sizeof(FreeBlock));
+    static constexpr std::size_t BLOCK_ALIGN = std::max(ALIGN, alignof(FreeBlock));
+    static constexpr int         CACHE_SIZE  = 16; /// free blocks a thread keeps for itself
+
+    /**
+     * Free blocks of all threads which are not in a cache.
+     */
+    struct Shared
+    {
+        std::mutex mutex_;          /// guards head_
+        FreeBlock* head_ = nullptr; /// first free block
+    };
+
+    /**
+     * Free blocks owned by a single thread, no synchronization needed.
+     */
+    struct Cache
+    {
+        Cache() = default;
+
+        // not copyable or movable
+        Cache(const Cache&) = delete;
+        Cache(Cache&&)      = delete;
+
+        Cache& operator=(const Cache&) = delete;
+        Cache& operator=(Cache&&) = delete;
+
+        /**
+         * The blocks of an exiting thread are still usable by the others.
+         */
+        ~Cache()
+        {
+            spill(count_);
+            isCacheGone() = true;
+        }
+
+        void push(FreeBlock* block)
+        {
+            block->next_ = head_;
+            head_        = block;
+            ++count_;
+        }
+
+        FreeBlock* pop()
+        {
+            FreeBlock* block = head_;
+            head_            = block->next_;
+            --count_;
+            return block;
+        }
+
+        /**
+         * Moves blocks to the shared list.
+         * @param count Number of blocks to move.
+         */
+        void spill(int count)
+        {
+            Shared&                     shared = getShared();
+            std::lock_guard<std::mutex> sharedGuard{shared.mutex_};
+            for (; count > 0 && head_ != nullptr; --count) {
+                FreeBlock* block = pop();
+                block->next_     = shared.head_;
+                shared.head_     = block;
+            }
+        }
+
+        FreeBlock* head_  = nullptr; /// first free block
+        int        count_ = 0;       /// number of free blocks
+    };
+
+    static void* newBlock()
+    {
+        if constexpr (BLOCK_ALIGN > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(BLOCK_SIZE, std::align_val_t{BLOCK_ALIGN});
+        } else {
+            return ::operator new(BLOCK_SIZE);
+        }
+    }
+
+    /**
+     * @return True on a thread which already destroyed its cache, trivially destructible so it stays valid.
+     */
+    static bool& isCacheGone()
+    {
+        thread_local bool cacheGone = false;
+        return cacheGone;
+    }
+
+    static Cache& getCache()
+    {
+        thread_local Cache cache;
+        return cache;
+    }
+
+    static Shared& getShared()
+    {
+        // never destroyed, threads exiting after the static destructors still return their blocks
+        static Shared& shared = *new Shared; // NOLINT(cppcoreguidelines-owning-memory)
+        return shared;
+    }
+};
+
+/**
+ * Allocator taking single objects from the BlockPool of their size. Used with std::allocate_shared
+ * the event and its reference count share one recycled block.
+ *
+ * @tparam T The type to allocate.
+ */
+template <typename T>
+struct PoolAllocator
+{
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept // NOLINT(google-explicit-constructor) rebind
+    {
+    }
+
+    T* allocate(std::size_t count)
+    {
+        if (count != 1) {
+            return std::allocator<T>{}.allocate(count);
+        }
+        return static_cast<T*>(BlockPool<sizeof(T), alignof(T)>::allocate());
+    }
+
+    void deallocate(T* memory, std::size_t count)
+    {
+        if (count != 1) {
+            std::allocator<T>{}.deallocate(memory, count);
+            return;
+        }
+        BlockPool<sizeof(T), alignof(T)>::deallocate(memory);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept
+    {
+        return false;
+    }
+};
+
+} // namespace adst::ep::test_engine::core::impl
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+
+namespace adst::ep::test_engine::core::impl {
+
+/**
+ * Link embedded in every item of an MpscQueue.
+ */
+struct MpscNode
+{
+    std::atomic<MpscNode*> next_{nullptr}; /// next (newer) item in the queue
+};
+
+/**
+ * Intrusive multi producer single consumer queue (see Dmitry Vyukov's "Intrusive MPSC node-based queue").
+ *
+ * push is wait free and can be called from any thread. pop, empty and the destructor shall only be
+ * called by the single consumer. The queue does not own the items, the consumer is responsible for
+ * releasing them after pop.
+ *
+ * @tparam T Item type, must be derived from MpscNode.
+ */
+template <typename T>
+class MpscQueue
+{
+    static_assert(std::is_base_of<MpscNode, T>::value, "mpsc queue items must be derived from MpscNode");
+
+public:
+    MpscQueue() = default;
+
+    // not copyable or movable, the items point into the queue via the stub
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue(MpscQueue&&)      = delete;
+
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    MpscQueue& operator=(MpscQueue&&) = delete;
+
+    ~MpscQueue() = default;
+
+    /**
+     * Adds an item to the queue. Can be called from any thread.
+     * @param item The item to add, it must stay alive until it is popped.
+     */
+    void push(T* item)
+    {
+        push(static_cast<MpscNode*>(item));
+    }
+
+    /**
+     * Takes the oldest item from the queue. Shall only be called by the consumer.
+     *
+     * Note: nullptr is also returned when a producer is in the middle of a push, in that case empty()
+     * is false and pop shall be retried.
+     * @return The oldest item or nullptr.
+     */
+    T* pop()
+    {
+        MpscNode* tail = tail_.load(std::memory_order_relaxed);
+        MpscNode* next = tail->next_.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            tail_.store(next, std::memory_order_relaxed);
+            tail = next;
+            next = next->next_.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail_.store(next, std::memory_order_relaxed);
+            return static_cast<T*>(tail);
+        }
+        if (tail != head_.load(std::memory_order_acquire)) {
+            return nullptr; // a producer has not yet linked its item
+        }
+        // tail is the last item, the stub is put behind it so tail can be handed out
+        push(&stub_);
+        next = tail->next_.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail_.store(next, std::memory_order_relaxed);
+            return static_cast<T*>(tail);
+        }
+        return nullptr;
+    }
+
+    /**
+     * Shall only be called by the consumer. It is safe (but not exact) when a consumer which is about to
+     * hand over the queue calls it while the next consumer already pops.
+     * @return True when there is no item in the queue, including the ones which are being pushed.
+     */
+    bool empty() const
+    {
+        return tail_.load(std::memory_order_relaxed) == &stub_ && head_.load(std::memory_order_acquire) == &stub_;
+    }
+
+private:
+    void push(MpscNode* node)
+    {
+        node->next_.store(nullptr, std::memory_order_relaxed);
+        MpscNode* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next_.store(node, std::memory_order_release);
+    }
+
+    // producers and the consumer work on different ends keep them on separate cache lines
+    MpscNode                           stub_;         /// placeholder keeping the queue never really empty
+    alignas(64) std::atomic<MpscNode*> head_{&stub_}; /// the newest item, producers swap it
+    alignas(64) std::atomic<MpscNode*> tail_{&stub_}; /// the oldest item, only written by the consumer
+};
+
+} // namespace adst::ep::test_engine::core::impl
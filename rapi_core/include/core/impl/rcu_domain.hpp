@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace adst::ep::test_engine::core::impl {
+
+/**
+ * Minimal read-copy-update grace period tracking.
+ *
+ * Readers enter a read section with ReadGuard, load the shared pointer, use it and leave. Writers
+ * replace the pointer with a new immutable copy, call synchronize() and can then delete the old copy,
+ * since no reader can still use it.
+ *
+ * Readers only increment and decrement a counter, they never block. There are two counters so a
+ * writer only waits for the readers which started before it swapped the pointer and is not starved
+ * by readers that keep on coming.
+ */
+class RcuDomain
+{
+public:
+    RcuDomain() = default;
+
+    // not copyable or movable, readers refer to the counters
+    RcuDomain(const RcuDomain&) = delete;
+    RcuDomain(RcuDomain&&)      = delete;
+
+    RcuDomain& operator=(const RcuDomain&) = delete;
+    RcuDomain& operator=(RcuDomain&&) = delete;
+
+    ~RcuDomain() = default;
+
+    /**
+     * Marks a read section for the life time of the object.
+     */
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(RcuDomain& domain)
+            : readers_(domain.readers_[domain.phase_.load() & 1U])
+        {
+            readers_.fetch_add(1);
+        }
+
+        // not copyable or movable
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard(ReadGuard&&)      = delete;
+
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+
+        ~ReadGuard()
+        {
+            readers_.fetch_sub(1);
+        }
+
+    private:
+        std::atomic<std::int64_t>& readers_; /// the counter this reader is accounted in
+    };
+
+    /**
+     * Blocks until all read sections which were entered before the call have been left. Writers
+     * shall be serialized by the caller.
+     */
+    void synchronize()
+    {
+        // a reader which picked up a phase just before the flip might still join the old counter, it
+        // then sees the new pointer. Flipping twice makes sure both counters drained once.
+        for (int flip = 0; flip < 2; ++flip) {
+            const unsigned draining = phase_.fetch_add(1) & 1U;
+            while (readers_[draining].load() != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    std::atomic<unsigned>     phase_ = {0};         /// selects the counter new readers are accounted in
+    std::atomic<std::int64_t> readers_[2] = {{0}, {0}}; /// number of readers in each phase
+};
+
+} // namespace adst::ep::test_engine::core::impl
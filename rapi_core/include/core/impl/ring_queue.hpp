@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace adst::ep::test_engine::core::impl {
+
+/**
+ * FIFO queue on a circular buffer. Unlike std::deque it keeps its storage when items are popped, so
+ * once it has grown to the steady state size push and pop never allocate.
+ *
+ * Not thread safe, the owner guards it. Popped slots are reset to a default constructed item so the
+ * resources of a moved out item (e.g. the captures of a callback) are not kept alive by the queue.
+ *
+ * @tparam T Item type, must be default constructible and move assignable.
+ */
+template <typename T>
+class RingQueue
+{
+public:
+    explicit RingQueue(std::size_t capacity = 16)
+        : slots_(capacity == 0 ? 1 : capacity)
+    {
+    }
+
+    /**
+     * Adds an item to the end of the queue, doubles the capacity when the queue is full.
+     * @param item The item to add.
+     */
+    void push_back(T item)
+    {
+        if (size_ == slots_.size()) {
+            grow();
+        }
+        slots_[(head_ + size_) % slots_.size()] = std::move(item);
+        ++size_;
+    }
+
+    /**
+     * Takes the oldest item out of the queue. Shall not be called on an empty queue.
+     * @return The oldest item.
+     */
+    T take_front()
+    {
+        T item        = std::move(slots_[head_]);
+        slots_[head_] = T{};
+        head_         = (head_ + 1) % slots_.size();
+        --size_;
+        return item;
+    }
+
+    /**
+     * @param index Position in the queue, 0 is the oldest item, shall be below size().
+     * @return The item at the position.
+     */
+    T& operator[](std::size_t index)
+    {
+        return slots_[(head_ + index) % slots_.size()];
+    }
+
+    /**
+     * Shall not be called on an empty queue.
+     * @return The newest item.
+     */
+    T& back()
+    {
+        return slots_[(head_ + size_ - 1) % slots_.size()];
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    void grow()
+    {
+        std::vector<T> slots(slots_.size() * 2);
+        for (std::size_t index = 0; index < size_; ++index) {
+            slots[index] = std::move(slots_[(head_ + index) % slots_.size()]);
+        }
+        slots_ = std::move(slots);
+        head_  = 0;
+    }
+
+    std::vector<T> slots_;     /// storage, the items are in [head_, head_ + size_) modulo the capacity
+    std::size_t    head_ = 0;  /// index of the oldest item
+    std::size_t    size_ = 0;  /// number of items in the queue
+};
+
+} // namespace adst::ep::test_engine::core::impl
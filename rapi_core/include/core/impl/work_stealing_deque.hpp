@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace adst::ep::test_engine::core::impl {
+
+/**
+ * Chase-Lev work stealing deque (see "Correct and Efficient Work-Stealing for Weak Memory Models",
+ * Le et al. 2013).
+ *
+ * Only the owner thread may push. Every thread (including the owner) takes from the top, which
+ * keeps the items of one dispatcher in FIFO order. Unlike the original algorithm the owner does not
+ * pop from the bottom, because LIFO order would let a busy actor overtake the others queued on the
+ * same dispatcher.
+ *
+ * The buffer grows on demand. Retired buffers are kept until the deque is destroyed since a
+ * concurrent thief might still read from them; the buffer size doubles so the overhead is bounded.
+ *
+ * @tparam T Item type, must be a trivially copyable type like a pointer.
+ */
+template <typename T>
+class WorkStealingDeque
+{
+    static_assert(std::is_trivially_copyable<T>::value, "work stealing deque items must be trivially copyable");
+
+public:
+    static constexpr std::int64_t DEFAULT_CAPACITY = 256; /// initial number of slots
+
+    explicit WorkStealingDeque(std::int64_t capacity = DEFAULT_CAPACITY)
+    {
+        buffers_.emplace_back(std::make_unique<Buffer>(capacity));
+        buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+    }
+
+    // not copyable or movable
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque(WorkStealingDeque&&)      = delete;
+
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+    ~WorkStealingDeque() = default;
+
+    /**
+     * Adds an item to the bottom of the deque. Shall only be called by the owner thread.
+     * @param item The item to add.
+     */
+    void push(T item)
+    {
+        std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        std::int64_t top    = top_.load(std::memory_order_acquire);
+        Buffer*      buffer = buffer_.load(std::memory_order_relaxed);
+        if (bottom - top > buffer->capacity_ - 1) {
+            buffer = grow(buffer, top, bottom);
+        }
+        buffer->put(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Takes the oldest item from the top of the deque. Can be called from any thread.
+     * @param item Filled with the taken item on success.
+     * @return True when an item was taken, false when the deque was empty or another thread won the race.
+     */
+    bool steal(T& item)
+    {
+        std::int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return false;
+        }
+        Buffer* buffer = buffer_.load(std::memory_order_acquire);
+        item           = buffer->get(top);
+        return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    /**
+     * Approximation of the item count, it is only exact when no other thread accesses the deque.
+     * @return Number of items in the deque.
+     */
+    std::int64_t size() const
+    {
+        std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        std::int64_t top    = top_.load(std::memory_order_relaxed);
+        return bottom > top ? bottom - top : 0;
+    }
+
+private:
+    /**
+     * Ring buffer of atomic slots. Capacity is always a power of 2.
+     */
+    struct Buffer
+    {
+        explicit Buffer(std::int64_t capacity)
+            : capacity_(capacity)
+            , slots_(std::make_unique<std::atomic<T>[]>(static_cast<std::size_t>(capacity)))
+        {
+        }
+
+        void put(std::int64_t index, T item)
+        {
+            slots_[static_cast<std::size_t>(index & (capacity_ - 1))].store(item, std::memory_order_relaxed);
+        }
+
+        T get(std::int64_t index) const
+        {
+            return slots_[static_cast<std::size_t>(index & (capacity_ - 1))].load(std::memory_order_relaxed);
+        }
+
+        const std::int64_t                capacity_; /// number of slots
+        std::unique_ptr<std::atomic<T>[]> slots_;    /// item storage
+    };
+
+    Buffer* grow(Buffer* old, std::int64_t top, std::int64_t bottom)
+    {
+        buffers_.emplace_back(std::make_unique<Buffer>(old->capacity_ * 2));
+        Buffer* buffer = buffers_.back().get();
+        for (std::int64_t index = top; index < bottom; ++index) {
+            buffer->put(index, old->get(index));
+        }
+        buffer_.store(buffer, std::memory_order_release);
+        return buffer;
+    }
+
+    // top and bottom are written by different threads keep them on separate cache lines
+    alignas(64) std::atomic<std::int64_t> top_{0};    /// next index to take, advanced by thieves
+    alignas(64) std::atomic<std::int64_t> bottom_{0}; /// next index to push, owned by the owner thread
+    std::atomic<Buffer*>                  buffer_{nullptr};
+    std::vector<std::unique_ptr<Buffer>>  buffers_; /// current and retired buffers, only touched by the owner
+};
+
+} // namespace adst::ep::test_engine::core::impl
@@ -41,6 +41,8 @@ struct ReqHelper
     ReqHelper& operator=(ReqHelper&&) = delete;
 
     ReqHelper() = default;
+
+    static constexpr bool URGENT = true; /// start and stop requests shall not wait behind queued traffic
 };
 
 template <typename ActorT>
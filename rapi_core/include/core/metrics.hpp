@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace adst::ep::test_engine::core {
+
+/**
+ * Copy of a latency histogram. The buckets are log-linear like in HDR histograms: each power of two
+ * is split into SUB_BUCKETS equal buckets, so a value is known with 1/SUB_BUCKETS relative precision
+ * from 1ns up to MAX_VALUE.
+ */
+struct LatencySnapshot
+{
+    static constexpr unsigned      SUB_BUCKET_BITS = 3;                    /// log2 of SUB_BUCKETS
+    static constexpr std::size_t   SUB_BUCKETS     = 1U << SUB_BUCKET_BITS; /// buckets per power of two
+    static constexpr unsigned      MAX_EXPONENT    = 40;                   /// values are clamped below 2^40ns (~18min)
+    static constexpr std::uint64_t MAX_VALUE       = (std::uint64_t{1} << MAX_EXPONENT) - 1;
+    static constexpr std::size_t   BUCKET_COUNT    = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    /**
+     * @param value A latency in ns.
+     * @return The bucket counting the value.
+     */
+    static std::size_t bucketOf(std::uint64_t value)
+    {
+        value = std::min(value, MAX_VALUE);
+        if (value < SUB_BUCKETS) {
+            return static_cast<std::size_t>(value);
+        }
+        const auto exponent = static_cast<unsigned>(63 - __builtin_clzll(value));
+        const auto shift    = exponent - SUB_BUCKET_BITS;
+        return (shift + 1) * SUB_BUCKETS + static_cast<std::size_t>((value >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    /**
+     * @param bucket Index of a bucket.
+     * @return The largest value counted by the bucket.
+     */
+    static std::uint64_t bucketMax(std::size_t bucket)
+    {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        const auto shift = static_cast<unsigned>(bucket / SUB_BUCKETS - 1);
+        const auto first = (SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+        return first + (std::uint64_t{1} << shift) - 1;
+    }
+
+    /**
+     * @param percentile Between 0 and 1.
+     * @return The value in ns the given part of the samples is below of (within the bucket precision),
+     *         0 if there are no samples.
+     */
+    std::uint64_t percentile(double percentile) const
+    {
+        if (count_ == 0) {
+            return 0;
+        }
+        const auto    rank = static_cast<std::uint64_t>(percentile * static_cast<double>(count_ - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < buckets_.size(); ++bucket) {
+            seen += buckets_[bucket];
+            if (seen >= rank) {
+                return std::min(bucketMax(bucket), max_);
+            }
+        }
+        return max_;
+    }
+
+    /**
+     * @return Average of the samples in ns, 0 if there are none.
+     */
+    std::uint64_t mean() const
+    {
+        return count_ == 0 ? 0 : sum_ / count_;
+    }
+
+    std::uint64_t              count_   = 0;  /// number of samples
+    std::uint64_t              sum_     = 0;  /// sum of the samples in ns
+    std::uint64_t              max_     = 0;  /// largest sample in ns
+    std::vector<std::uint64_t> buckets_ = {}; /// samples per bucket, BUCKET_COUNT entries
+};
+
+/**
+ * Metrics of one message type received by one actor.
+ */
+struct MessageMetrics
+{
+    std::string     actor_;         /// name of the receiving actor
+    std::string     type_;          /// name of the message type
+    std::uint64_t   queued_;        /// messages queued for the actor
+    std::uint64_t   dispatched_;    /// messages the actor has dispatched
+    std::uint64_t   maxQueueDepth_; /// most messages of the type waiting at once
+    std::uint64_t   dropped_;       /// messages dropped or replaced because the port was full
+    std::uint64_t   conflated_;     /// queued messages replaced by a newer one in a conflating listen
+    LatencySnapshot latency_;       /// time from queueing to the start of the dispatch
+    LatencySnapshot service_;       /// time spent in the listeners of the actor
+};
+
+/**
+ * Metrics of all actors, one entry per actor and message type.
+ */
+using MetricsSnapshot = std::vector<MessageMetrics>;
+
+} // namespace adst::ep::test_engine::core
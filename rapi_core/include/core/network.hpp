@@ -1,12 +1,16 @@
 #pragma once
 
+#include <atomic>
+#include <algorithm>
 #include <cassert>
 #include <iostream>
-#include <map>
+#include <memory>
 #include <mutex>
+#include <vector>
 #include "adstlog_cxx/adstlog.hpp"
 #include "core/impl/async_call_back_vector.hpp"
 #include "core/impl/common.hpp"
+#include "core/impl/rcu_domain.hpp"
 
 namespace adst::ep::test_engine::core {
 /**
@@ -14,19 +18,22 @@ namespace adst::ep::test_engine::core {
  *
  * Actors are registering when they listen for a message on a port to a network. So when that
  * message is published to the network actors will be scheduled for dispatch by the priority.
+ *
+ * The listeners of an event type are stored in an immutable snapshot. Listen and unlisten copy the
+ * snapshot, swap it in and release the old one after all publishers left it (read-copy-update), so
+ * publish does not take any lock and publishers of different event types do not share any state
+ * which is written.
  */
 class Network
 {
 public:
-    ~Network()
-    {
-        std::lock_guard<std::mutex> guard{callbacksMutex_};
-        callbacks_.clear();
-    }
+    ~Network() = default;
 
     Network()
     {
         ADSTLOG_INIT_ACTOR_TRACE_MODULES("Network");
+        tables_.emplace_back(std::make_unique<TopicTable>(INITIAL_TOPIC_COUNT));
+        topicTable_.store(tables_.back().get());
     }
 
     Network(const Network&) = delete;
@@ -38,6 +45,8 @@ public:
     /**
      * Registers a callback to an Event.
      *
+     * Shall not be called from a callback of the network, it waits for the running publishes.
+     *
      * @tparam Event The event type to be dispatched.
      * @param callback The callback which is scheduled for dispatching when event is published.
      * @return Unique handle (can be used later for unlisten)
@@ -52,6 +61,32 @@ public:
         return handle;
     }
 
+    /**
+     * Removes a callback registered by listen(..). Unknown handles are ignored.
+     *
+     * Shall not be called from a callback of the network, it waits for the running publishes.
+     *
+     * @tparam Event The event type used in listen.
+     * @param handle The handle returned by listen.
+     */
+    template <typename Event>
+    void unlisten(const CallBackHandle handle)
+    {
+        static_assert(impl::validateEvent<Event>(), "Invalid event");
+        std::lock_guard<std::mutex> writerGuard{callbacksMutex_};
+
+        using Vector = impl::AsyncCallbackVector<std::shared_ptr<Event>>;
+        Topic* topic = findTopic(*topicTable_.load(std::memory_order_relaxed), impl::type_index<Event>());
+        if (topic == nullptr || topic->subscribers_.load() == nullptr) {
+            return;
+        }
+        auto next = std::make_unique<Vector>(*static_cast<const Vector*>(topic->subscribers_.load()));
+        if (next->remove(handle)) {
+            next.reset(); // publish finds no listener
+        }
+        replaceSubscribers(*topic, std::move(next));
+    }
+
     /**
      * Broadcasts all event to all registered callbacks (from listen(..)).
      *
@@ -62,23 +97,40 @@ public:
      */
     template <typename Event>
     void publish(std::unique_ptr<Event> event)
+    {
+        publish(std::shared_ptr<Event>(std::move(event)));
+    }
+
+    /**
+     * Broadcasts an already shared event to all registered callbacks (from listen(..)).
+     *
+     * Listeners only get const access, so the same event instance can be published again, which
+     * saves the allocation of the shared state per publish.
+     *
+     * @tparam Event the event type to publish.
+     * @param shareableEvent Shared ptr to the event, shall not be modified after publish.
+     */
+    template <typename Event>
+    void publish(std::shared_ptr<Event> shareableEvent)
     {
         static_assert(impl::validateEvent<Event>(), "Invalid event");
-        std::shared_ptr<Event>      shareableEvent = std::move(event);
-        std::lock_guard<std::mutex> lambdaCallbacksGuard{callbacksMutex_};
 
         using Vector = impl::AsyncCallbackVector<std::shared_ptr<Event>>;
-        auto found   = callbacks_.find(impl::type_id<Event>());
-        LOG_C_D("%s", impl::getTypeName<Event>().c_str());
-        if (found == callbacks_.end()) {
-            LOG_C_W("no listener:{%s}", impl::getTypeName<Event>().c_str());
+        Topic* topic = findTopic(*topicTable_.load(std::memory_order_acquire), impl::type_index<Event>());
+        LOG_C_D("%s", impl::getTypeName<Event>());
+        if (topic == nullptr) {
+            LOG_C_W("no listener:{%s}", impl::getTypeName<Event>());
             return; // no such notifications
         }
 
-        std::unique_ptr<impl::CallbackVector>& vector = found->second;
+        impl::RcuDomain::ReadGuard readGuard{topic->rcu_};
         //            assert(dynamic_cast<Vector*>(vector.get()));
-        auto callbacks = static_cast<Vector*>(vector.get());
-        LOG_C_T("listeners:{%s}, size=%d", impl::getTypeName<Event>().c_str(), callbacks->container_.size());
+        auto callbacks = static_cast<const Vector*>(topic->subscribers_.load(std::memory_order_acquire));
+        if (callbacks == nullptr) {
+            LOG_C_W("no listener:{%s}", impl::getTypeName<Event>());
+            return; // all listeners are gone
+        }
+        LOG_C_T("listeners:{%s}, size=%d", impl::getTypeName<Event>(), callbacks->container_.size());
         for (const auto& element : callbacks->container_) {
             element.second(shareableEvent);
         }
@@ -86,13 +138,49 @@ public:
 
 private:
     /**
-     * Stores the AsyncCallBackVector by base class CallbackVector event is hidden.
+     * Listeners of a single event type.
      */
-    using CallBackVector = std::unique_ptr<impl::CallbackVector>;
+    struct Topic
+    {
+        ~Topic()
+        {
+            delete subscribers_.load(); // NOLINT(cppcoreguidelines-owning-memory)
+        }
+
+        impl::RcuDomain rcu_; /// tracks the publishers which are using subscribers_
+        /// immutable snapshot of the AsyncCallBackVector of the event, nullptr when nobody listens
+        std::atomic<const impl::CallbackVector*> subscribers_ = {nullptr};
+    };
+
     /**
-     * Mapping of type_id and CallBackVector is used in runtime to get back the callbacks for a specific event type.
+     * Lookup of the topic by the type index of the event, used in runtime to get back the callbacks
+     * for a specific event type. A slot is only written once, when the first listen of the event type
+     * happens. When a type index does not fit a new table with twice the size replaces it.
      */
-    using TypeIdToCallBackVector = std::map<impl::type_id_t, CallBackVector>;
+    struct TopicTable
+    {
+        explicit TopicTable(size_t size)
+            : topics_(size)
+        {
+        }
+
+        std::vector<std::atomic<Topic*>> topics_; /// indexed by type index, nullptr when nobody listened yet
+    };
+
+    static constexpr size_t INITIAL_TOPIC_COUNT = 64; /// size of the first topic table
+
+    /**
+     * @param table The table to search in.
+     * @param typeIndex The type index of the event.
+     * @return The topic of the event type or nullptr if the type has no topic.
+     */
+    static Topic* findTopic(const TopicTable& table, const impl::type_index_t typeIndex)
+    {
+        if (typeIndex >= table.topics_.size()) {
+            return nullptr;
+        }
+        return table.topics_[typeIndex].load(std::memory_order_acquire);
+    }
 
     /**
      * Registers or Overwrites a Callback in the internal store with the given callback function
@@ -104,22 +192,63 @@ private:
     template <typename Event>
     void listen(const CallBackHandle handle, std::function<void(const std::shared_ptr<Event>)> callback)
     {
-        std::lock_guard<std::mutex> lambdaCallbacksGuard{callbacksMutex_};
+        std::lock_guard<std::mutex> writerGuard{callbacksMutex_};
 
         using Vector = impl::AsyncCallbackVector<std::shared_ptr<Event>>;
         // GCOVR_EXCL_START
         assert(callback && "callback should be valid"); // Check for valid object
         // GCOVR_EXCL_STOP
-        std::unique_ptr<impl::CallbackVector>& vector = callbacks_[impl::type_id<Event>()];
-        // GCOVR_EXCL_START
-        if (vector == nullptr) {
-            // GCOVR_EXCL_STOP
-            vector.reset(new Vector{});
-        }
+        Topic& topic   = getTopic(impl::type_index<Event>());
+        auto   current = static_cast<const Vector*>(topic.subscribers_.load());
         //            assert(dynamic_cast<Vector*>(vector.get())); // ToDo RSZRSZ Create ifdef for RTTI enabled ...
-        auto callbacks = static_cast<Vector*>(vector.get());
-        callbacks->add(handle, callback);
+        auto next = current == nullptr ? std::make_unique<Vector>() : std::make_unique<Vector>(*current);
+        next->add(handle, std::move(callback));
+        replaceSubscribers(topic, std::move(next));
     }
+
+    /**
+     * Looks up the topic of an event type and creates it if it does not exist yet. Shall be called
+     * with callbacksMutex_ locked.
+     *
+     * @param typeIndex The type index of the event.
+     * @return The topic of the event type.
+     */
+    Topic& getTopic(const impl::type_index_t typeIndex)
+    {
+        TopicTable* table = topicTable_.load(std::memory_order_relaxed);
+        if (Topic* topic = findTopic(*table, typeIndex)) {
+            return *topic;
+        }
+        if (typeIndex >= table->topics_.size()) {
+            auto next = std::make_unique<TopicTable>(std::max<size_t>(typeIndex + 1, 2 * table->topics_.size()));
+            for (size_t index = 0; index < table->topics_.size(); ++index) {
+                next->topics_[index].store(table->topics_[index].load(std::memory_order_relaxed));
+            }
+            table = next.get();
+            topicTable_.store(table, std::memory_order_release);
+            // publishers might still read the previous tables, they are only released with the network
+            // which is fine since the table size doubles each time.
+            tables_.emplace_back(std::move(next));
+        }
+        topics_.emplace_back(std::make_unique<Topic>());
+        table->topics_[typeIndex].store(topics_.back().get(), std::memory_order_release);
+        return *topics_.back();
+    }
+
+    /**
+     * Swaps in a new listener snapshot and releases the previous one after all publishers using it
+     * have finished. Shall be called with callbacksMutex_ locked.
+     *
+     * @param topic The topic to update.
+     * @param next The new snapshot, nullptr when there are no listeners.
+     */
+    static void replaceSubscribers(Topic& topic, std::unique_ptr<const impl::CallbackVector> next)
+    {
+        const impl::CallbackVector* previous = topic.subscribers_.exchange(next.release());
+        topic.rcu_.synchronize();
+        delete previous; // NOLINT(cppcoreguidelines-owning-memory)
+    }
+
     /**
      * Creates a unique handle used for callback listen.
      *
@@ -132,9 +261,11 @@ private:
         return handle;
     }
 
-    CallBackHandle         handleCounter_ = 0;  /// counter used as for unique handle generation
-    TypeIdToCallBackVector callbacks_     = {}; /// lookup of type to callback function
-    mutable std::mutex     callbacksMutex_;     /// the guard mutex for multi threaded access
+    CallBackHandle                           handleCounter_ = 0;  /// counter used as for unique handle generation
+    std::vector<std::unique_ptr<Topic>>      topics_        = {}; /// all topics, one per event type ever listened
+    std::vector<std::unique_ptr<TopicTable>> tables_        = {}; /// all lookup tables, the last one is the current
+    std::atomic<TopicTable*>                 topicTable_    = {nullptr}; /// lookup of type to topic, read by publish
+    mutable std::mutex                       callbacksMutex_; /// serializes listen and unlisten, not used by publish
     ADSTLOG_DEF_ACTOR_TRACE_MODULES();
 };
 
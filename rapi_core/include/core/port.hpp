@@ -2,21 +2,25 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
-#include <deque>
 #include <functional>
 #include <limits>
-#include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <iostream>
 
 #include "adstlog_cxx/adstlog.hpp"
 #include "adstutil_cxx/compiler_diagnostics.hpp"
+#include "core/core_types.hpp"
 #include "core/impl/async_call_back_vector.hpp"
 #include "core/impl/common.hpp"
+#include "core/impl/message_metrics.hpp"
+#include "core/impl/ring_queue.hpp"
 #include "core/network.hpp"
+#include "core/priority.hpp"
 
 namespace adst::ep::test_engine::core {
 
@@ -50,7 +54,8 @@ public:
     ~Port()
     {
         std::lock_guard<std::mutex> guard{callbacksMutex_};
-        callbacks_.clear();
+        std::lock_guard<std::mutex> eventGuard{eventMutex_};
+        channels_.clear();
     }
 
     Port()            = delete;
@@ -61,15 +66,19 @@ public:
     Port& operator=(const Port&) = delete;
 
     /**
-     * Creates unique handle for each listen registration.
+     * Creates unique handle for each listen registration. The handles are unique among all ports of
+     * the owner.
      *
      * @return A unique handle.
      */
-    CallBackHandle newHandle()
+    CallBackHandle newHandle();
+
+    /**
+     * @return The network this port is attached to.
+     */
+    Network& getNetwork() const
     {
-        std::lock_guard<std::mutex> guard{eventMutex_};
-        auto                        handle = ++handleCounter_;
-        return handle;
+        return network_;
     }
 
     /**
@@ -89,6 +98,21 @@ public:
         return handle;
     }
 
+    /**
+     * Same as listen(), but the port keeps only the newest queued event of the type, or the newest
+     * per key. A new event replaces the queued one in place, so it is dispatched at the position of
+     * the event it replaced. This applies to all listeners of the type on this port.
+     *
+     * @tparam Event The event type used for callback (and for registration).
+     * @param callback The callback to be called when a publish happens on a network.
+     * @param keyOf Key of an event, events with different keys are kept apart. Empty for a single
+     *        slot per type.
+     * @return Unique ID to identify the callback during unlisten.
+     */
+    template <typename Event>
+    CallBackHandle listenLatest(std::function<void(const Event&)>          callback,
+                                std::function<ConflationKey(const Event&)> keyOf = nullptr);
+
     /**
      * Listen can be changed to a different function by providing the unique id and a new callback.
      *
@@ -107,10 +131,13 @@ public:
     void unlistenAll(const CallBackHandle handle)
     {
         std::lock_guard<std::mutex> unListenCmdQueueGuard{eventMutex_};
-        commandsQueue_.emplace_back([this, handle]() {
+        commandsQueue_.push_back([this, handle]() {
             std::lock_guard<std::mutex> lambdaCallbacksGuard{callbacksMutex_};
-            for (auto& element : callbacks_) {
-                element.second->remove(handle);
+            std::lock_guard<std::mutex> lambdaEventGuard{eventMutex_}; // channels_ might grow in schedule
+            for (auto& channel : channels_) {
+                if (channel != nullptr) {
+                    channel->getCallbacks().remove(handle);
+                }
             }
         });
     }
@@ -148,12 +175,38 @@ public:
 
     /**
      * Consumes all commands and event from the queue which was pushed by schedule to the port.
+     * Stops early when the activation budget of the owner is used up.
      *
      * @param max might be that not all event needs to be dispatched so a maximum number of event to dispatch
      * @return the number of event has been dispatched.
      */
     int consume(int max = std::numeric_limits<int>::max());
 
+    /**
+     * Limits the events dispatched each time the port gets its turn in the mailbox of the owner. When
+     * the budget is used up the port queues itself again behind the other ports of the owner, so a
+     * busy port does not hold back the others. Shall be called in actor context.
+     *
+     * @param maxEvents Events dispatched per turn, 0 means no limit.
+     */
+    void setDrainBudget(int maxEvents)
+    {
+        drainBudget_ = maxEvents > 0 ? maxEvents : std::numeric_limits<int>::max();
+    }
+
+    /**
+     * Bounds the events queued on the port, the default comes from the environment. When the port is
+     * full the policy decides what happens to a new event, drops are counted in the metrics.
+     *
+     * @param limit The capacity and the overload policy.
+     */
+    void setLimit(PortLimit limit)
+    {
+        std::lock_guard<std::mutex> guard{eventMutex_};
+        limit_ = limit;
+        roomAvailable_.notify_all();
+    }
+
     /**
      * The number of events in the queue (waiting to be dispatched).
      *
@@ -162,20 +215,163 @@ public:
     std::size_t getQueueEventCount() const
     {
         std::lock_guard<std::mutex> guard{eventMutex_};
-        return eventQueue_.size();
+        return urgentOrder_.size() + dispatchOrder_.size();
     }
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Queued events and registered callbacks of a single event type, the event type is hidden.
+     */
+    struct ChannelBase
+    {
+        virtual ~ChannelBase() = default;
+
+        /// metrics of the event type, shared with the environment, nullptr when metrics are disabled
+        std::shared_ptr<impl::MessageCounters> counters_;
+        /// queue time of each event in events_ when metrics are enabled, guarded by eventMutex_
+        impl::RingQueue<Clock::time_point> queuedAt_;
+
+        /**
+         * Takes the oldest event of the channel and dispatches it to the callbacks.
+         * @param eventLock The locked eventMutex_, it is unlocked before the callbacks are called.
+         */
+        virtual void dispatchNext(std::unique_lock<std::mutex>& eventLock) = 0;
+
+        /**
+         * @return The callbacks of the channel.
+         */
+        virtual impl::CallbackVector& getCallbacks() = 0;
+
+        /**
+         * Drops the oldest event of the channel, the caller took its entry out of the dispatch order.
+         */
+        virtual void dropOldest() = 0;
+
+        /**
+         * Counts an event dropped or replaced by the overload policy.
+         */
+        void countDrop()
+        {
+            if (counters_ != nullptr) {
+                counters_->dropped();
+            }
+        }
+    };
+
+    /**
+     * The events are stored typed together with the callbacks of the type, so dispatching an event
+     * needs neither a lookup nor a closure.
+     * @tparam EventT The type of the event.
+     */
+    template <typename EventT>
+    struct Channel final : public ChannelBase
+    {
+        explicit Channel(Port& port)
+            : port_(port)
+        {
+            counters_ = port_.newCounters(impl::getTypeName<EventT>());
+        }
+
+        void dispatchNext(std::unique_lock<std::mutex>& eventLock) override
+        {
+            port_.dispatch(*this, eventLock);
+        }
+
+        impl::CallbackVector& getCallbacks() override
+        {
+            return callbacks_;
+        }
+
+        /**
+         * Replaces the queued event with the same key as the new one. Shall be called with eventMutex_
+         * locked and only when conflate_ is set.
+         * @param event The new event.
+         * @return True when an event was replaced, false when the new event shall be queued.
+         */
+        bool replaceQueued(std::shared_ptr<EventT>& event)
+        {
+            if (events_.empty()) {
+                return false;
+            }
+            if (!keyOf_) {
+                events_.back() = std::move(event);
+                return true;
+            }
+            const ConflationKey key = keyOf_(*event);
+            for (std::size_t index = 0; index < events_.size(); ++index) {
+                if (keyOf_(*events_[index]) == key) {
+                    events_[index] = std::move(event);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void dropOldest() override
+        {
+            events_.take_front();
+            if (counters_ != nullptr) {
+                queuedAt_.take_front();
+            }
+            countDrop();
+        }
+
+        Port&                                       port_;      /// the port owning the channel
+        impl::RingQueue<std::shared_ptr<EventT>>    events_;    /// queued events, guarded by eventMutex_
+        impl::AsyncCallbackVector<EventT>           callbacks_; /// registered callbacks, guarded by callbacksMutex_
+        bool                                        conflate_ = false; /// keep the newest event (per key) only
+        std::function<ConflationKey(const EventT&)> keyOf_;            /// key of the events, empty for one slot
+    };
+
+    /**
+     * Indexed by the type index of the event, used to find the channel of an event type when it is
+     * scheduled or listened. Slots of event types which were never used on the port are nullptr.
+     */
+    using TypeIndexToChannel = std::vector<std::unique_ptr<ChannelBase>>;
+
+    /**
+     * Looks up the channel of an event type and creates it if it does not exist yet. Shall be called
+     * with eventMutex_ locked.
+     * @tparam EventT The type of the event.
+     * @return The channel of the event type.
+     */
+    template <typename EventT>
+    Channel<EventT>& getChannel();
+
+    /**
+     * Dispatches the oldest event of a channel.
+     * @tparam EventT The type of the event.
+     * @param channel The channel to take the event from.
+     * @param eventLock The locked eventMutex_, it is unlocked before the callbacks are called.
+     */
+    template <typename EventT>
+    void dispatch(Channel<EventT>& channel, std::unique_lock<std::mutex>& eventLock);
+
+    /**
+     * Shall be called with eventMutex_ locked.
+     * @return True when the port has reached its capacity.
+     */
+    bool isFull() const
+    {
+        return limit_.capacity_ != 0 && urgentOrder_.size() + dispatchOrder_.size() >= limit_.capacity_;
+    }
+
     /**
-     * Stores the AsyncCallBackVector by base class CallbackVector event is hidden.
+     * Applies the overload policy of a full port to a new event, except the conflation of KEEP_LATEST
+     * which needs the event type. Shall be called with eventMutex_ locked.
+     * @param channel The channel of the new event.
+     * @param eventLock The locked eventMutex_, BLOCK unlocks it while waiting.
+     * @return True when the new event shall be queued.
      */
-    using CallBackVector = std::unique_ptr<impl::CallbackVector>;
+    bool makeRoom(ChannelBase& channel, std::unique_lock<std::mutex>& eventLock);
 
     /**
-     * Mapping of type_id and CallBackVector is used at runtime to get back the callbacks for a
-     * specific event type.
+     * @param typeName The event type of a new channel.
+     * @return The metrics of the event type on this port, nullptr when metrics are disabled.
      */
-    using TypeIdToCallBackVector = std::map<impl::type_id_t, CallBackVector>;
+    std::shared_ptr<impl::MessageCounters> newCounters(const char* typeName);
 
     /**
      * Helper to process the CommandQueue and return the event queue size as a single operation
@@ -195,22 +391,39 @@ private:
      */
     void scheduleOnOwner(); // must be called from locked queue mutex content; ToDo RSZRSZ Add enforcement.
 
-    CallBackHandle         handleCounter_ = 0;  /// used as a counter to generate unique callback handles
-    TypeIdToCallBackVector callbacks_     = {}; /// the store for the callbacks registered for an event
-    mutable std::mutex     callbacksMutex_;     /// guard for the command queue
-    mutable std::mutex     eventMutex_;         /// quard for the event queue
+    TypeIndexToChannel channels_        = {}; /// the store for the events and callbacks of an event type
+    std::vector<bool>  networkListened_ = {}; /// by type index, true when registered on the network
+    mutable std::mutex callbacksMutex_;       /// guard for the callbacks in the channels
+    mutable std::mutex eventMutex_;           /// quard for the event queues and channels_
+    std::mutex         networkMutex_;         /// guard for networkListened_
 
     /**
-     * Queue stores all events for dispatching
+     * The channel of each scheduled event in the order of schedule, so the events of different types
+     * are dispatched in the same order as they were scheduled.
      */
-    std::deque<std::function<void()>> eventQueue_;
+    impl::RingQueue<ChannelBase*> dispatchOrder_;
+
+    /**
+     * Same as dispatchOrder_ for the event types carrying the urgency hint, dispatched first.
+     */
+    impl::RingQueue<ChannelBase*> urgentOrder_;
 
     /**
      * Queue stores all commands for dispatching
      */
-    std::deque<std::function<void()>> commandsQueue_;
+    impl::RingQueue<CallBack> commandsQueue_;
+
+    /**
+     * Queued in the mailbox of the owner when the port has something to dispatch. Reused for every
+     * schedule so scheduling the port does not allocate.
+     */
+    Job consumeJob_{[this] { consume(drainBudget_); }};
+    int drainBudget_ = std::numeric_limits<int>::max(); /// events dispatched per turn, see setDrainBudget()
     Actor&   owner_;   // it is a reference because ports are owned by actor and port schedules itself on an actor.
-    Network& network_; // it is now a reference it probably ones dynamic connections are allowed must change to some
+    Network& network_; // the network the port is attached to, lives as long as the environment of the owner
+
+    PortLimit               limit_;         /// bound of the queued events, guarded by eventMutex_
+    std::condition_variable roomAvailable_; /// publishers blocked by OverloadPolicy::BLOCK wait on it
 
     /**
      * A state has to be maintained that the port is already in the actors queue. If it is there is
@@ -230,78 +443,150 @@ void Port::listen(const CallBackHandle handle, std::function<void(const Event&)>
 {
     static_assert(impl::validateEvent<Event>(), "Invalid event");
 
+    const auto typeIndex = impl::type_index<Event>();
+    {
+        // registered right away (and not by the command) so events published before the command is
+        // processed are already queued and get dispatched after the callback has been added.
+        // eventMutex_ shall not be held here, the network waits for publishers which lock it.
+        std::lock_guard<std::mutex> networkGuard{networkMutex_};
+        if (typeIndex >= networkListened_.size()) {
+            networkListened_.resize(typeIndex + 1, false);
+        }
+        if (!networkListened_[typeIndex]) {
+            networkListened_[typeIndex] = true;
+            network_.listen<Event>([this](const std::shared_ptr<Event> event) { schedule(event); });
+        }
+    }
+
     std::lock_guard<std::mutex> listenCmdQueueGuard{eventMutex_};
 
-    commandsQueue_.push_back([this, handle, callback = std::move(callback)]() {
+    auto& channel = getChannel<Event>();
+    commandsQueue_.push_back([this, &channel, handle, callback = std::move(callback)]() {
         // it is not shadowing since the lambda is not executed in the listen call context
 
         std::lock_guard<std::mutex> lambdaCallbacksGuard{callbacksMutex_};
 
-        using Vector = impl::AsyncCallbackVector<Event>;
         // GCOVR_EXCL_START
         assert(callback && "callback should be valid"); // Check for valid object
                                                         // GCOVR_EXCL_STOP
-        auto& vector = callbacks_[impl::type_id<Event>()];
-        // GCOVR_EXCL_START
-        if (vector == nullptr) {
-            // GCOVR_EXCL_STOP
-            vector.reset(new Vector{});
-            network_.listen<Event>([this](const std::shared_ptr<Event> event) { schedule(event); });
-        }
-        //            assert(dynamic_cast<Vector*>(vector.get())); // ToDo RSZRSZ Create ifdef for RTTI enabled ...
-        auto callbacks = static_cast<Vector*>(vector.get());
-        LOG_C_D("Port::listen:{%s}", impl::getTypeName<Event>().c_str());
-        callbacks->add(handle, callback);
+        LOG_C_D("Port::listen:{%s}", impl::getTypeName<Event>());
+        channel.callbacks_.add(handle, callback);
     });
     scheduleOnOwner();
 }
 
+template <typename Event>
+CallBackHandle Port::listenLatest(std::function<void(const Event&)>          callback,
+                                  std::function<ConflationKey(const Event&)> keyOf)
+{
+    {
+        // set right away (and not by the command) so the events scheduled from now on are conflated
+        std::lock_guard<std::mutex> eventGuard{eventMutex_};
+        auto&                       channel = getChannel<Event>();
+        channel.conflate_                   = true;
+        channel.keyOf_                      = std::move(keyOf);
+    }
+    return listen<Event>(std::move(callback));
+}
+
 template <typename Event>
 void Port::schedule(Event event)
 {
     using EventT = typename std::remove_reference<decltype(*Event())>::type;
     static_assert(impl::validateEvent<EventT>(), "Invalid event");
-    std::shared_ptr<EventT>     shareableEvent = std::move(event);
-    std::lock_guard<std::mutex> scheduleCmdQueueGuard{eventMutex_};
-    LOG_C_D("Port::schedule, dispatch:{%s}", impl::getTypeName<EventT>().c_str());
-    eventQueue_.push_back([this, event = std::move(shareableEvent)]() {
-        std::lock_guard<std::mutex> lambdaCallbacksGuard{callbacksMutex_};
-
-        using Vector = impl::AsyncCallbackVector<EventT>;
-        auto found   = callbacks_.find(impl::type_id<EventT>());
-        LOG_C_D("Port::schedule, dispatch:{%s}", impl::getTypeName<EventT>().c_str());
-        // GCOVR_EXCL_START
-        if (found == callbacks_.end()) {
-            // GCOVR_EXCL_STOP
-            LOG_C_D("Port::schedule, no listener:{%s}", impl::getTypeName<EventT>().c_str());
-            return; // no such notifications
+    std::shared_ptr<EventT>      shareableEvent = std::move(event);
+    std::unique_lock<std::mutex> eventLock{eventMutex_};
+    LOG_C_D("Port::schedule, dispatch:{%s}", impl::getTypeName<EventT>());
+    impl::FlowTrace::record<EventT>(impl::FlowEvent::QUEUE, owner_.flowId_);
+    auto& channel = getChannel<EventT>();
+    // a replaced event keeps its queue time, the latency is the age of the oldest update not yet seen
+    if (channel.conflate_ && channel.replaceQueued(shareableEvent)) {
+        if (channel.counters_ != nullptr) {
+            channel.counters_->conflated();
         }
-        std::unique_ptr<impl::CallbackVector>& vector = found->second;
-        //            assert(dynamic_cast<Vector*>(vector.get()));
-        auto callbacks = static_cast<Vector*>(vector.get());
-        LOG_C_D("Port::schedule, dispatch:{%s}, callbacks.size=%d", impl::getTypeName<EventT>().c_str(),
-                callbacks->container_.size());
-        for (const auto& element : callbacks->container_) {
-            LOG_CH_D(MSG_RX, "%s", impl::getTypeName<EventT>().c_str());
-            element.second(*event);
+        return;
+    }
+    if (isFull()) {
+        if (limit_.policy_ == OverloadPolicy::KEEP_LATEST && !channel.events_.empty()) {
+            channel.events_.back() = std::move(shareableEvent); // it keeps the queue time of the replaced one
+            channel.countDrop();
+            return;
         }
-    });
+        if (!makeRoom(channel, eventLock)) {
+            return;
+        }
+    }
+    channel.events_.push_back(std::move(shareableEvent));
+    if (channel.counters_ != nullptr) {
+        channel.queuedAt_.push_back(Clock::now());
+        channel.counters_->queued(channel.events_.size());
+    }
+    if constexpr (impl::isUrgent<EventT>()) {
+        urgentOrder_.push_back(&channel);
+    } else {
+        dispatchOrder_.push_back(&channel);
+    }
     scheduleOnOwner();
 }
 
+template <typename EventT>
+Port::Channel<EventT>& Port::getChannel()
+{
+    const auto typeIndex = impl::type_index<EventT>();
+    if (typeIndex >= channels_.size()) {
+        channels_.resize(typeIndex + 1);
+    }
+    auto& channel = channels_[typeIndex];
+    if (channel == nullptr) {
+        channel = std::make_unique<Channel<EventT>>(*this);
+    }
+    //            assert(dynamic_cast<Channel<EventT>*>(channel.get()));
+    return static_cast<Channel<EventT>&>(*channel);
+}
+
+template <typename EventT>
+void Port::dispatch(Channel<EventT>& channel, std::unique_lock<std::mutex>& eventLock)
+{
+    std::shared_ptr<EventT> event    = channel.events_.take_front();
+    const Clock::time_point queuedAt = channel.counters_ != nullptr ? channel.queuedAt_.take_front() : Clock::time_point{};
+    const bool              blocking = limit_.policy_ == OverloadPolicy::BLOCK;
+    eventLock.unlock();
+    if (blocking) {
+        roomAvailable_.notify_all();
+    }
+
+    std::lock_guard<std::mutex> callbacksGuard{callbacksMutex_};
+    const auto&                 container = channel.callbacks_.container_;
+    LOG_C_D("Port::schedule, dispatch:{%s}, callbacks.size=%d", impl::getTypeName<EventT>(), container.size());
+    // GCOVR_EXCL_START
+    if (container.empty()) {
+        // GCOVR_EXCL_STOP
+        LOG_C_D("Port::schedule, no listener:{%s}", impl::getTypeName<EventT>());
+        return; // no such notifications
+    }
+    impl::FlowTrace::record<EventT>(impl::FlowEvent::DISPATCH_BEGIN, owner_.flowId_);
+    const Clock::time_point start = channel.counters_ != nullptr ? Clock::now() : Clock::time_point{};
+    for (const auto& element : container) {
+        LOG_CH_D(MSG_RX, "%s", impl::getTypeName<EventT>());
+        element.second(*event);
+    }
+    if (channel.counters_ != nullptr) {
+        channel.counters_->dispatched(queuedAt, start, Clock::now());
+    }
+    impl::FlowTrace::record<EventT>(impl::FlowEvent::DISPATCH_END, owner_.flowId_);
+}
+
 template <typename Event>
 void Port::unlisten(const CallBackHandle handle)
 {
     static_assert(impl::validateEvent<Event>(), "Invalid event");
     std::lock_guard<std::mutex> unListenCmdQueueGuard{eventMutex_};
-    commandsQueue_.push_back([this, handle]() {
+    auto&                       channel = getChannel<Event>();
+    commandsQueue_.push_back([this, &channel, handle]() {
         std::lock_guard<std::mutex> lambdaCallbacksGuard{callbacksMutex_};
 
-        auto found = callbacks_.find(impl::type_id<Event>());
-        if (found != callbacks_.end()) {
-            LOG_C_D("Port::unlisten:{%s}", impl::getTypeName<Event>().c_str());
-            found->second->remove(handle); // ToDo RSZRSZ unlisten from Network.
-        }
+        LOG_C_D("Port::unlisten:{%s}", impl::getTypeName<Event>());
+        channel.callbacks_.remove(handle); // ToDo RSZRSZ unlisten from Network.
     });
     scheduleOnOwner();
 }
@@ -1,22 +1,96 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <deque>
-#include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 #include "adstlog_cxx/adstlog.hpp"
 
 #include "adstutil_cxx/error_handler.hpp"
+#include "core/core_types.hpp"
+#include "core/impl/inline_function.hpp"
+#include "core/impl/io_engine.hpp"
+#include "core/impl/mpsc_queue.hpp"
+#include "core/impl/work_stealing_deque.hpp"
 
 namespace adst::ep::test_engine::core {
 
 /**
  * * Type to be used for callbacks on priority. Shall be a simple void function.
+ * The captures are stored inline (no allocation), a capture which does not fit fails to compile.
  */
-using CallBack = std::function<void()>;
+using CallBack = impl::InlineFunction<void()>;
+
+/**
+ * Unit of work scheduled on the priority or queued in the mailbox of an actor.
+ *
+ * Owners which schedule the same work repeatedly (e.g. an actor scheduling its own consume) keep a
+ * single Job alive and schedule it again after it has been executed. This way the dispatchers only
+ * pass pointers around. A Job shall not be scheduled again before its previous schedule has started
+ * executing.
+ */
+struct Job : public impl::MpscNode
+{
+    explicit Job(CallBack callBack, bool deleteAfterRun = false)
+        : callBack_(std::move(callBack))
+        , deleteAfterRun_(deleteAfterRun)
+    {
+    }
+
+    CallBack callBack_;               /// the function executed by a dispatcher
+    bool     deleteAfterRun_ = false; /// set for jobs allocated by the scheduling function itself
+};
+
+/**
+ * OS level settings of the dispatcher threads of a priority. The defaults leave the threads as they
+ * are created, only the name is applied.
+ */
+struct DispatcherSettings
+{
+    /**
+     * Scheduling policy of the dispatcher threads.
+     */
+    enum class Policy
+    {
+        INHERIT, /// keep the policy of the creating thread
+        OTHER,   /// SCHED_OTHER, time shared with nice_
+        FIFO,    /// SCHED_FIFO, real time with priority_
+    };
+
+    /**
+     * What a dispatcher does when it has no job. Spinning trades cpu time for wake-up latency.
+     */
+    enum class IdlePolicy
+    {
+        PARK,      /// sleep on the condition variable right away
+        SPIN,      /// spin spinCount_ times, yield yieldCount_ times, then sleep
+        BUSY_SPIN, /// never sleep, spin until a job arrives or the priority stops
+    };
+
+    static constexpr int DEFAULT_SPIN_COUNT      = 1000; /// default spin iterations of IdlePolicy::SPIN
+    static constexpr int DEFAULT_YIELD_COUNT     = 100;  /// default yield iterations of IdlePolicy::SPIN
+    static constexpr int DEFAULT_IO_BUFFER_COUNT = 256;  /// default receive buffers of an I/O engine
+    static constexpr int DEFAULT_IO_BUFFER_SIZE  = 2048; /// default bytes per receive buffer
+
+    std::string      name_       = "dispatcher";        /// thread name prefix, the index of the dispatcher is appended
+    std::vector<int> cpus_       = {};                  /// cpus the dispatchers may run on, empty means no affinity
+    bool             pinEach_    = false;               /// pin dispatcher i to cpus_[i % size] only instead of all cpus_
+    Policy           policy_     = Policy::INHERIT;     /// scheduling policy
+    int              priority_   = 0;                   /// real time priority, used by FIFO only
+    int              nice_       = 0;                   /// nice value, used by INHERIT and OTHER when not 0
+    IdlePolicy       idlePolicy_ = IdlePolicy::PARK;    /// behaviour of dispatchers without a job
+    int              spinCount_  = DEFAULT_SPIN_COUNT;  /// busy wait iterations before yielding
+    int              yieldCount_ = DEFAULT_YIELD_COUNT; /// yield iterations before sleeping
+    IoBackend        ioBackend_  = IoBackend::NONE;     /// socket I/O of the dispatchers, see Actor::receive()
+    /// receive buffers of each dispatcher (io_uring, rounded up to a power of two) or of each socket (epoll)
+    int ioBufferCount_ = DEFAULT_IO_BUFFER_COUNT;
+    int ioBufferSize_  = DEFAULT_IO_BUFFER_SIZE; /// bytes per receive buffer, longer datagrams are truncated
+};
 
 class Priority final
 {
@@ -32,8 +106,10 @@ public:
      * Creates dispatchers and handles startup and shutdown of the system in a graceful way.
      * @param dispatcherCount Number of parallel dispatchers to run.
      * @param onErrorCallBack Function to be be called in case of errors.
+     * @param settings Thread name, affinity and scheduling policy of the dispatchers.
      */
-    Priority(int dispatcherCount, const adst::common::OnErrorCallBack& onErrorCallBack);
+    Priority(int dispatcherCount, const adst::common::OnErrorCallBack& onErrorCallBack,
+             DispatcherSettings settings = {});
 
     ~Priority();
 
@@ -54,11 +130,58 @@ public:
      */
     void schedule(CallBack callBack);
 
+    /**
+     * Schedules a job owned by the caller. The job must stay alive until it has been executed.
+     *
+     * When called from a dispatcher of this priority the job is pushed to the local queue of the calling
+     * dispatcher (idle dispatchers steal it from there), otherwise it goes to the shared injection queue.
+     * @param job The job to schedule.
+     */
+    void schedule(Job& job);
+
+    /**
+     * Schedules a job owned by the caller on a single dispatcher. The other dispatchers never steal
+     * it, so work scheduled the same way (e.g. an actor) keeps running on the same thread and finds
+     * its data in the cache of that cpu.
+     * @param job The job to schedule, it must stay alive until it has been executed.
+     * @param dispatcher Index of the dispatcher, taken modulo the dispatcher count.
+     */
+    void schedule(Job& job, std::size_t dispatcher);
+
+    /**
+     * @return The number of dispatchers of the priority.
+     */
+    std::size_t getDispatcherCount() const
+    {
+        return dispatchers_.size();
+    }
+
     /**
      * Blocks calling thread until all dispatcher thread in idle state, eg no callback to dispatch.
      */
     void waitForIdle();
 
+    /**
+     * @return The I/O engine of the calling dispatcher, nullptr if the priority has no I/O backend or
+     *         the caller is no dispatcher of this priority.
+     */
+    impl::IoEngine* getCurrentIoEngine() const
+    {
+        return (currentDispatcher_ != nullptr && &currentDispatcher_->owner_ == this)
+                   ? currentDispatcher_->ioEngine_.get()
+                   : nullptr;
+    }
+
+    /**
+     * The number of schedule calls since construction. Used to find out whether work has been handed
+     * between priorities while waiting for them to become idle.
+     * @return Number of jobs scheduled so far.
+     */
+    std::uint64_t getScheduledCount() const
+    {
+        return scheduledCount_.load();
+    }
+
 private:
     /**
      * Internal start event it takes the lock as input since in destructor this is locked for more than one start stop
@@ -74,11 +197,89 @@ private:
      */
     void stop(std::unique_lock<std::mutex>& lock);
 
+    /**
+     * Per dispatcher thread data. Each dispatcher has a local queue, jobs scheduled from a dispatcher
+     * thread go to its own queue so dispatchers do not contend on a single lock.
+     */
+    struct alignas(64) Dispatcher
+    {
+        explicit Dispatcher(Priority& owner, int index)
+            : owner_(owner)
+            , index_(index)
+        {
+        }
+
+        Priority&                     owner_;            /// the priority this dispatcher belongs to
+        const int                     index_;            /// index in dispatchers_
+        impl::WorkStealingDeque<Job*> localQueue_;       /// jobs scheduled from this dispatcher
+        impl::MpscQueue<Job>          pinnedQueue_;      /// jobs only this dispatcher executes
+        std::atomic<std::int64_t>     pinnedCount_ = {0}; /// jobs in pinnedQueue_ not yet taken
+        std::atomic<bool>             parked_      = {false}; /// sleeping on scheduleEvent_, written under stateChangeMutex_
+        std::thread                   thread_;           /// the dispatcher thread
+        std::string                   name_;             /// thread name
+        std::string                   applied_;          /// the applied settings, reported by start
+        /// socket I/O, the dispatcher sleeps in it instead of on scheduleEvent_, nullptr without I/O backend
+        std::unique_ptr<impl::IoEngine> ioEngine_;
+        int                             jobsSinceIoPoll_ = 0; /// jobs executed since the engine was polled
+    };
+
+    /**
+     * Applies settings_ to the calling dispatcher thread. Failures (e.g. missing permission for
+     * SCHED_FIFO) are not fatal, they are part of the report.
+     * @param dispatcher The calling dispatcher.
+     */
+    void applySettings(Dispatcher& dispatcher);
+
     /**
      * function runs on the thread context preforms dispatching of callbacks.
-     * @param threadId
+     * @param dispatcher The data of the calling dispatcher.
+     */
+    inline void dispatcherLoop(Dispatcher& dispatcher);
+
+    /**
+     * Takes the next job for a dispatcher: first the jobs pinned to it, then from its local queue,
+     * then from the injection queue and finally by stealing from the other dispatchers.
+     * @param dispatcher The calling dispatcher.
+     * @return The job to execute or nullptr if none found.
+     */
+    Job* takeJob(Dispatcher& dispatcher);
+
+    /**
+     * Idles the calling dispatcher according to the idle policy until a job is queued or the priority
+     * is stopped. The dispatcher counts as sleeping (idle) while spinning as well.
+     * @param dispatcher The calling dispatcher.
+     * @return False when the dispatcher shall exit.
+     */
+    bool idle(Dispatcher& dispatcher);
+
+    /**
+     * Spins (and yields) till a job is queued, the priority stops or the spin budget is used up.
+     * @param dispatcher The calling dispatcher.
+     * @return True when the dispatcher shall stop spinning because there is a job or the priority stopped.
+     */
+    bool spin(const Dispatcher& dispatcher);
+
+    /**
+     * Wakes a dispatcher parked in its I/O engine and counts it as no longer parked, so the next wake
+     * goes to another one. Shall be called with stateChangeMutex_ locked.
+     * @param dispatcher A parked dispatcher.
+     */
+    void unpark(Dispatcher& dispatcher);
+
+    /**
+     * @param dispatcher A dispatcher of the priority.
+     * @return True when there is a job the dispatcher can take.
+     */
+    bool hasJob(const Dispatcher& dispatcher) const
+    {
+        return queuedCount_.load(std::memory_order_acquire) > 0 ||
+               dispatcher.pinnedCount_.load(std::memory_order_acquire) > 0;
+    }
+
+    /**
+     * The dispatcher executing on the current thread, nullptr on non dispatcher threads.
      */
-    inline void dispatcherLoop(int threadId);
+    thread_local static Dispatcher* currentDispatcher_;
 
     /**
      * Priority executes sequence of actions based on current state and internal events see  bellow.
@@ -95,11 +296,17 @@ private:
     // but for that 2 queue or polymorphic queue element would have been necessary.
     // Since the only command for now is STOP, both solution would have been overkill.
 
-    const adst::common::OnErrorCallBack& onErrorCallBack_;  /// error callback from environment no return
-    std::vector<std::thread>             dispatchers_ = {}; /// store dispatcher threads
-    std::deque<CallBack>                 actorQueue_  = {}; /// the CallBack queue to be dispatched in dispatcher thread
-    std::mutex stateChangeMutex_                      = {}; /// guard for internal state change queue or state variable
-    /// either when the Actor queue changes form empty or when Start or Stop signalled
+    const adst::common::OnErrorCallBack&     onErrorCallBack_;  /// error callback from environment no return
+    const DispatcherSettings                 settings_;         /// os settings of the dispatcher threads
+    std::vector<std::unique_ptr<Dispatcher>> dispatchers_ = {}; /// store dispatcher threads and their queues
+    std::deque<Job*> injectionQueue_ = {}; /// jobs scheduled from threads other than the dispatchers
+    std::mutex       injectionMutex_ = {}; /// guard for the injection queue
+    /// number of jobs scheduled but not yet taken by a dispatcher, without the pinned ones
+    std::atomic<std::int64_t>  queuedCount_      = {0};
+    std::atomic<std::int64_t>  pinnedCount_      = {0}; /// number of pinned jobs not yet taken
+    std::atomic<std::uint64_t> scheduledCount_   = {0}; /// number of schedule calls, never decremented
+    std::mutex                 stateChangeMutex_ = {}; /// guard for internal state change or state variable
+    /// signalled when a job is scheduled while dispatchers sleep or when Start or Stop signalled
     /// this signal wakes up the dispatcher threads
     std::condition_variable scheduleEvent_ = {};
     /// Used the dispatchers to signal that they are waiting for dispatching used during start
@@ -110,11 +317,15 @@ private:
     int                     startCount_   = 0;  /// guard variable to unlock start
     /// a change from STARTING to RUNNING triggers startedEvent_ -> Main to dispatchers,
     /// a change from RUNNING to STOPPED triggers again startedEvent_ -> last dispatcher to Main,
-    State state_ = State::START;
+    std::atomic<State> state_ = {State::START};
     /// using it for idle wait.
-    /// incremented/decremented when a dispatcher thread goes to/from sleep
-    size_t                  sleepingCount_ = 0;
-    std::condition_variable idleEvent_     = {}; /// signal when all dispatcher sleeps.
+    /// incremented/decremented when a dispatcher thread goes to/from idle, written under stateChangeMutex_
+    std::atomic<size_t> sleepingCount_ = {0};
+    /// idle dispatchers which are spinning, they pick up new jobs without a notify
+    std::atomic<size_t> spinningCount_ = {0};
+    /// idle dispatchers sleeping on scheduleEvent_, written under stateChangeMutex_
+    std::atomic<size_t>     parkedCount_ = {0};
+    std::condition_variable idleEvent_   = {}; /// signal when all dispatcher sleeps.
     ADSTLOG_DEF_ACTOR_TRACE_MODULES();
 };
 
@@ -1,85 +1,245 @@
 #include <iostream>
+#include <thread>
 
 #include "core/actor.hpp"
 
-using Actor          = adst::ep::test_engine::core::Actor;
-using CallBackHandle = adst::ep::test_engine::core::CallBackHandle;
+using Actor           = adst::ep::test_engine::core::Actor;
+using CallBackHandle  = adst::ep::test_engine::core::CallBackHandle;
+using OverloadPolicy  = adst::ep::test_engine::core::OverloadPolicy;
+using PortLimit       = adst::ep::test_engine::core::PortLimit;
+using PriorityLevel   = adst::ep::test_engine::core::PriorityLevel;
+using ReceiveCallBack = adst::ep::test_engine::core::ReceiveCallBack;
 
-thread_local int Actor::thread_id;
+thread_local int          Actor::thread_id;
+thread_local const Actor* Actor::running_ = nullptr;
 
 Actor::Actor(std::string name, const adst::ep::test_engine::core::Environment& env)
     : name_(std::move(name))
     , env_(env)
-    , ctorDtorLock_(callBackMutex_)
+    , flowId_(impl::FlowTrace::registerActor(name_))
+    , priorityLevel_(PriorityLevel::NORMAL)
+    , priority_(&env.getPriority(priorityLevel_))
+    , pinnedDispatcher_(-1)
+    , consumeJob_{[this] { consume(); }}
+    , activationBudget_{env.configAndLogger_.config_.maxMessagesPerActivation_,
+                        env.configAndLogger_.config_.maxActivationTime_}
 {
     ADSTLOG_INIT_ACTOR_TRACE_MODULES(name_.c_str());
-    scheduled_ = true;
-    ctorDtorLock_.unlock(); // allow from here to be receive events.
+    // actors:
+    //   <name>:
+    //     dispatcher: 2 # bound to this dispatcher of its priority, see pinToDispatcher()
+    const auto& doc = env.configAndLogger_.config_.configDoc_;
+    if (auto dispatcher = doc.getValue<int>("/actors/" + name_ + "/dispatcher"); dispatcher.first) {
+        if (dispatcher.second < 0) {
+            env.configAndLogger_.config_.onErrorCallBack_(adst::common::Error{
+                {6, fmt::format("invalid config value /actors/{}/dispatcher: '{}'", name_, dispatcher.second)}});
+        }
+        pinnedDispatcher_ = dispatcher.second;
+    }
+    // scheduled_ stays true till ctorFinished() so callbacks are only queued but not dispatched.
     ports_.emplace_back(std::make_unique<Port>(*this, env_.network_));
 }
 
+Actor::~Actor()
+{
+    // callbacks which were never dispatched
+    while (Job* job = mailbox_.pop()) {
+        if (job->deleteAfterRun_) {
+            delete job; // NOLINT(cppcoreguidelines-owning-memory)
+        }
+    }
+}
+
 void Actor::ctorFinished()
 {
-    LOG_C_T("lock[ctorDtorLock_] - try to lock");
-    ctorDtorLock_.lock(); // now ctor finished check when every scheduling is needed
-    LOG_C_T("lock[ctorDtorLock_] - locked");
-    if (!callBackQueue_.empty()) {
-        LOG_C_D("callBackQueue_ not empty - schedule");
-        env_.priority_.schedule([this] { consume(); });
-        ctorDtorLock_.unlock(); // make sure that now we can dispatch
-        LOG_C_T("lock[ctorDtorLock_] - unlocked");
+    if (!mailbox_.empty()) {
+        LOG_C_D("mailbox not empty - schedule");
+        post();
         LOG_C_D("ctor end");
         return;
     }
-    LOG_C_D("callBackQueue_ empty - no schedule");
-    scheduled_ = false;
-    ctorDtorLock_.unlock(); // really done with construction we unlock. So normal operation
-    LOG_C_T("lock[ctorDtorLock_] - unlocked");
+    LOG_C_D("mailbox empty - no schedule");
+    if (releaseScheduled()) {
+        post();
+    }
     LOG_C_D("ctor end");
 }
 
 void Actor::waitForReadyToDtor()
 {
-    ctorDtorLock_.lock(); // we entering destruction phase no more dispatch allowed.
-    if (scheduled_) {
-        constDestEvent_.wait(ctorDtorLock_, [this] { return !scheduled_; });
+    // we entering destruction phase no more dispatch allowed, taking scheduled_ over makes sure that
+    // nobody posts the actor any more.
+    bool expected = false;
+    while (!scheduled_.compare_exchange_weak(expected, true)) {
+        expected = false;
+        std::this_thread::yield();
+    }
+    // the last consume might still be on its way out after it released scheduled_
+    while (consuming_.load() != 0) {
+        std::this_thread::yield();
     }
 }
 
 void Actor::consume()
 {
-    std::unique_lock<std::mutex> callBackLock(callBackMutex_);
-    LOG_C_D("Actor::consume, callBackQueue.size=%d", callBackQueue_.size());
+    consuming_.fetch_add(1);
+    running_ = this;
+    LOG_C_D("Actor::consume");
+    startActivation();
     while (true) {
-        if (!callBackQueue_.empty()) {
-            auto callback = callBackQueue_.front();
-            callBackQueue_.pop_front();
-            callBackLock.unlock();
-            callback();
-            callBackLock.lock();
-        } else {
-            scheduled_ = false;
-            constDestEvent_.notify_one();
-            return;
+        Job* job = mailbox_.pop();
+        if (job != nullptr) {
+            // a job owned by a port might be queued again by the time the callback returns
+            const bool deleteAfterRun = job->deleteAfterRun_;
+            job->callBack_();
+            if (deleteAfterRun) {
+                delete job; // NOLINT(cppcoreguidelines-owning-memory)
+            }
+            if (activationExhausted_ && !mailbox_.empty()) {
+                // scheduled_ stays true, the actor goes to the tail of the priority with the rest of the mailbox
+                LOG_C_D("activation budget used up, re-queue");
+                post();
+                break;
+            }
+        } else if (mailbox_.empty() && !releaseScheduled()) {
+            break;
+        } // else a producer is in the middle of a push, retry
+    }
+    running_ = nullptr;
+    consuming_.fetch_sub(1); // no member access allowed after this point, the actor might be destroyed
+}
+
+void Actor::startActivation()
+{
+    activationMessagesLeft_ = activationBudget_.maxMessages_;
+    activationExhausted_    = false;
+    if (activationBudget_.maxTime_.count() > 0) {
+        activationDeadline_ = std::chrono::steady_clock::now() + activationBudget_.maxTime_;
+    }
+}
+
+bool Actor::chargeActivation()
+{
+    if (activationBudget_.maxMessages_ > 0 && --activationMessagesLeft_ <= 0) {
+        activationExhausted_ = true;
+    }
+    if (activationBudget_.maxTime_.count() > 0 && std::chrono::steady_clock::now() >= activationDeadline_) {
+        activationExhausted_ = true;
+    }
+    return activationExhausted_;
+}
+
+bool Actor::releaseScheduled()
+{
+    scheduled_.store(false);
+    // a producer might have pushed after the mailbox was seen empty but when scheduled_ was still true
+    if (mailbox_.empty() || scheduled_.exchange(true)) {
+        return false;
+    }
+    return true;
+}
+
+void Actor::post()
+{
+    if (pinnedDispatcher_ < 0) {
+        priority_->schedule(consumeJob_);
+    } else {
+        priority_->schedule(consumeJob_, static_cast<std::size_t>(pinnedDispatcher_));
+    }
+}
+
+void Actor::schedule(CallBack callBack)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory) deleted by consume
+    schedule(*new Job(std::move(callBack), true));
+}
+
+void Actor::schedule(Job& job)
+{
+    mailbox_.push(&job);
+
+    if (!scheduled_.exchange(true)) {
+        post();
+    }
+}
+
+void Actor::receive(int fd, ReceiveCallBack callBack)
+{
+    receivers_.push_back(std::make_unique<SocketReceiver>(*this, fd, std::move(callBack)));
+    // the engine belongs to the dispatcher, it is only known once the actor runs there
+    schedule([this, receiver = receivers_.back().get()] { startReceive(*receiver); });
+}
+
+void Actor::stopReceive(int fd)
+{
+    for (auto& receiver : receivers_) {
+        if (receiver->fd_ == fd) {
+            stopReceive(*receiver);
         }
     }
 }
 
-void Actor::schedule(std::function<void()> callBack)
+void Actor::startReceive(SocketReceiver& receiver)
+{
+    if (receiver.fd_ < 0) {
+        return; // stopped before it was started
+    }
+    receiver.engine_ = priority_->getCurrentIoEngine();
+    if (pinnedDispatcher_ < 0 || receiver.engine_ == nullptr) {
+        env_.configAndLogger_.config_.onErrorCallBack_(adst::common::Error{
+            {6, fmt::format("{}.receive({}) needs the actor bound to a dispatcher with an I/O backend", getName(),
+                            receiver.fd_)}});
+        return;
+    }
+    receiver.ioReceiver_ = &receiver.engine_->addReceiver(
+        receiver.fd_, [this, &receiver](impl::IoReceiver&) { schedule(receiver.batchJob_); });
+}
+
+void Actor::stopReceive(SocketReceiver& receiver)
+{
+    if (receiver.ioReceiver_ != nullptr) {
+        receiver.engine_->removeReceiver(*receiver.ioReceiver_);
+        receiver.ioReceiver_ = nullptr;
+    }
+    receiver.fd_ = -1;
+}
+
+void Actor::stopReceiving()
 {
-    std::lock_guard<std::mutex> callBackGuard(callBackMutex_);
-    callBackQueue_.push_back(std::move(callBack));
+    for (auto& receiver : receivers_) {
+        stopReceive(*receiver);
+    }
+}
 
-    // since there is only a single port exist it always changes from 0 to 1 never more.
-    // GCOVR_EXCL_START
-    if (!scheduled_) {
-        // GCOVR_EXCL_STOP
-        scheduled_ = true;
-        env_.priority_.schedule([this] { consume(); });
+void Actor::dispatchBatch(SocketReceiver& receiver)
+{
+    if (receiver.ioReceiver_ == nullptr) {
+        return; // stopped while the batch was queued, the engine dropped it
+    }
+    receiver.callBack_(receiver.ioReceiver_->datagrams_);
+    if (receiver.ioReceiver_ != nullptr) { // the callback might have stopped receiving
+        receiver.engine_->release(*receiver.ioReceiver_);
     }
 }
 
 CallBackHandle Actor::newCallBackHandle()
 {
-    return ports_[0]->newHandle();
+    return ++handleCounter_;
+}
+
+Actor::PortIndex Actor::attachPort(const std::string& network, int maxMessages)
+{
+    ports_.emplace_back(std::make_unique<Port>(*this, env_.getNetwork(network)));
+    ports_.back()->setDrainBudget(maxMessages);
+    return ports_.size() - 1;
+}
+
+void Actor::setPortLimit(PortIndex port, std::size_t capacity, OverloadPolicy policy)
+{
+    ports_[port]->setLimit(PortLimit{capacity, policy});
+}
+
+void Actor::setPortBudget(PortIndex port, int maxMessages)
+{
+    ports_[port]->setDrainBudget(maxMessages);
 }
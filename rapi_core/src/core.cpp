@@ -7,10 +7,37 @@ using Core = adst::ep::test_engine::core::Core;
 void Core::run()
 {
     running_ = true;
-    env_.priority_.start();
-    env_.priority_.waitForIdle(); // start is delayed as long as all listen is executed from the actors ctor.
+    env_.startPriorities();
+    env_.waitForIdle(); // start is delayed as long as all listen is executed from the actors ctor.
     sendStartReq_();
     std::unique_lock<std::mutex> stopLock(stopMutex_);
-    stopEvent_.wait(stopLock, [this] { return !running_; });
-    env_.priority_.stop();
+    if (env_.metricsEnabled_ && env_.metricsLogPeriod_.count() > 0) {
+        while (!stopEvent_.wait_for(stopLock, env_.metricsLogPeriod_, [this] { return !running_; })) {
+            logMetrics();
+        }
+    } else {
+        stopEvent_.wait(stopLock, [this] { return !running_; });
+    }
+    env_.waitForIdle(); // the priorities can only stop together, they schedule actors on each other
+    env_.stopPriorities();
+    if (!env_.flowTraceFile_.empty() && !impl::FlowTrace::dump(env_.flowTraceFile_)) {
+        LOG_C_E("failed to write the flow trace to '%s'", env_.flowTraceFile_.c_str());
+    }
+}
+
+void Core::logMetrics()
+{
+    for (const auto& metrics : env_.collectMetrics()) {
+        const auto& latency = metrics.latency_;
+        const auto& service = metrics.service_;
+        LOG_C_I("metrics %s{%s}: queued=%llu dispatched=%llu maxDepth=%llu dropped=%llu conflated=%llu "
+                "latency(us) p50=%.1f p99=%.1f max=%.1f service(us) p50=%.1f p99=%.1f max=%.1f",
+                metrics.actor_.c_str(), metrics.type_.c_str(), static_cast<unsigned long long>(metrics.queued_),
+                static_cast<unsigned long long>(metrics.dispatched_),
+                static_cast<unsigned long long>(metrics.maxQueueDepth_),
+                static_cast<unsigned long long>(metrics.dropped_),
+                static_cast<unsigned long long>(metrics.conflated_), latency.percentile(0.5) / 1000.0,
+                latency.percentile(0.99) / 1000.0, latency.max_ / 1000.0, service.percentile(0.5) / 1000.0,
+                service.percentile(0.99) / 1000.0, service.max_ / 1000.0);
+    }
 }
@@ -1,9 +1,347 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include <fmt/format.h>
 #include "core/environment.hpp"
+#include "core/impl/flow_trace.hpp"
 
+using adst::common::Config;
 using adst::common::ConfigAndLogger;
+using adst::common::Error;
+using adst::ep::test_engine::core::DispatcherSettings;
 using adst::ep::test_engine::core::Environment;
+using adst::ep::test_engine::core::IoBackend;
+using adst::ep::test_engine::core::MetricsSnapshot;
+using adst::ep::test_engine::core::Network;
+using adst::ep::test_engine::core::OverloadPolicy;
+using adst::ep::test_engine::core::PortLimit;
+using adst::ep::test_engine::core::Priority;
+using adst::ep::test_engine::core::PriorityLevel;
+
+namespace {
+
+/**
+ * Parses a cpu list like "0-3,6" and appends the cpus to the settings.
+ * @return false if the list is malformed.
+ */
+bool parseCpuList(const std::string& cpuList, DispatcherSettings& settings)
+{
+    const char* next = cpuList.c_str();
+    while (*next != '\0') {
+        char*      end   = nullptr;
+        const long first = std::strtol(next, &end, 10);
+        long       last  = first;
+        if (end == next || first < 0) {
+            return false;
+        }
+        next = end;
+        if (*next == '-') {
+            last = std::strtol(next + 1, &end, 10);
+            if (end == next + 1 || last < first) {
+                return false;
+            }
+            next = end;
+        }
+        for (long cpu = first; cpu <= last; ++cpu) {
+            settings.cpus_.push_back(static_cast<int>(cpu));
+        }
+        if (*next == ',') {
+            ++next;
+        } else if (*next != '\0') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Reads the dispatcher settings of a priority level from the config doc:
+ *
+ *     dispatchers:
+ *       high:
+ *         cpus: 2-3          # cpu list or sequence of cpu lists
+ *         pinEach: true      # dispatcher i runs on the i-th cpu only
+ *         policy: SCHED_FIFO # or SCHED_OTHER
+ *         priority: 10       # SCHED_FIFO priority
+ *         nice: -5           # SCHED_OTHER nice value
+ *         idle: spin         # park (default), spin or busySpin
+ *         spinCount: 1000    # spin iterations before yielding
+ *         yieldCount: 100    # yield iterations before parking
+ *         io: uring          # socket I/O of the dispatchers: none (default), epoll or uring
+ *         ioBuffers: 256     # receive buffers of a dispatcher (uring) or of a socket (epoll)
+ *         ioBufferSize: 2048 # bytes per receive buffer
+ *
+ * @param config The config holding the doc and the error callback.
+ * @param levelName The key of the level and the thread name prefix of its dispatchers.
+ * @return The settings, a level not present in the doc gets the defaults.
+ */
+DispatcherSettings readDispatcherSettings(const Config& config, const std::string& levelName)
+{
+    const auto&        doc  = config.configDoc_;
+    const auto         path = "/dispatchers/" + levelName + "/";
+    DispatcherSettings settings;
+    settings.name_ = levelName;
+
+    auto onBadValue = [&config, &path](const char* key, const std::string& value) {
+        config.onErrorCallBack_(Error{{6, fmt::format("invalid config value {}{}: '{}'", path, key, value)}});
+    };
+
+    if (doc.getValue<std::string>(path + "cpus/0").first) {
+        for (int index = 0;; ++index) {
+            auto cpus = doc.getValue<std::string>(path + "cpus/" + std::to_string(index));
+            if (!cpus.first) {
+                break;
+            }
+            if (!parseCpuList(cpus.second, settings)) {
+                onBadValue("cpus", cpus.second);
+            }
+        }
+    } else if (auto cpus = doc.getValue<std::string>(path + "cpus"); cpus.first && !parseCpuList(cpus.second, settings)) {
+        onBadValue("cpus", cpus.second);
+    }
+
+    if (auto pinEach = doc.getValue<bool>(path + "pinEach"); pinEach.first) {
+        settings.pinEach_ = pinEach.second;
+    }
+
+    if (auto policy = doc.getValue<std::string>(path + "policy"); policy.first) {
+        if (policy.second == "SCHED_FIFO") {
+            settings.policy_ = DispatcherSettings::Policy::FIFO;
+        } else if (policy.second == "SCHED_OTHER") {
+            settings.policy_ = DispatcherSettings::Policy::OTHER;
+        } else {
+            onBadValue("policy", policy.second);
+        }
+    }
+
+    if (auto priority = doc.getValue<int>(path + "priority"); priority.first) {
+        settings.priority_ = priority.second;
+    }
+
+    if (auto nice = doc.getValue<int>(path + "nice"); nice.first) {
+        settings.nice_ = nice.second;
+    }
+
+    if (auto idle = doc.getValue<std::string>(path + "idle"); idle.first) {
+        if (idle.second == "park") {
+            settings.idlePolicy_ = DispatcherSettings::IdlePolicy::PARK;
+        } else if (idle.second == "spin") {
+            settings.idlePolicy_ = DispatcherSettings::IdlePolicy::SPIN;
+        } else if (idle.second == "busySpin") {
+            settings.idlePolicy_ = DispatcherSettings::IdlePolicy::BUSY_SPIN;
+        } else {
+            onBadValue("idle", idle.second);
+        }
+    }
+
+    if (auto spinCount = doc.getValue<int>(path + "spinCount"); spinCount.first) {
+        settings.spinCount_ = spinCount.second;
+    }
+
+    if (auto yieldCount = doc.getValue<int>(path + "yieldCount"); yieldCount.first) {
+        settings.yieldCount_ = yieldCount.second;
+    }
+
+    if (auto io = doc.getValue<std::string>(path + "io"); io.first) {
+        if (io.second == "none") {
+            settings.ioBackend_ = IoBackend::NONE;
+        } else if (io.second == "epoll") {
+            settings.ioBackend_ = IoBackend::EPOLL;
+        } else if (io.second == "uring") {
+            settings.ioBackend_ = IoBackend::IO_URING;
+        } else {
+            onBadValue("io", io.second);
+        }
+    }
+
+    if (auto ioBuffers = doc.getValue<int>(path + "ioBuffers"); ioBuffers.first) {
+        if (ioBuffers.second <= 0) {
+            onBadValue("ioBuffers", std::to_string(ioBuffers.second));
+        }
+        settings.ioBufferCount_ = ioBuffers.second;
+    }
+
+    if (auto ioBufferSize = doc.getValue<int>(path + "ioBufferSize"); ioBufferSize.first) {
+        if (ioBufferSize.second <= 0) {
+            onBadValue("ioBufferSize", std::to_string(ioBufferSize.second));
+        }
+        settings.ioBufferSize_ = ioBufferSize.second;
+    }
+    return settings;
+}
+
+/**
+ * Reads the flow trace settings from the config doc and enables the trace when asked for:
+ *
+ *     flowTrace:
+ *       enabled: true    # record the message flow
+ *       capacity: 16384  # records kept per thread
+ *       file: flow.trace # dump written when Core::run() returns
+ *
+ * @param config The config holding the doc and the error callback.
+ * @return The file to dump the trace to, empty if none.
+ */
+std::string readFlowTraceSettings(const Config& config)
+{
+    using adst::ep::test_engine::core::impl::FlowTrace;
+    const auto& doc = config.configDoc_;
+
+    std::size_t capacity = FlowTrace::DEFAULT_CAPACITY;
+    if (auto configured = doc.getValue<int>("/flowTrace/capacity"); configured.first) {
+        if (configured.second <= 0) {
+            config.onErrorCallBack_(Error{
+                {6, fmt::format("invalid config value /flowTrace/capacity: '{}'", configured.second)}});
+        } else {
+            capacity = static_cast<std::size_t>(configured.second);
+        }
+    }
+    if (auto enabled = doc.getValue<bool>("/flowTrace/enabled"); enabled.first && enabled.second) {
+        FlowTrace::enable(capacity);
+    }
+    auto file = doc.getValue<std::string>("/flowTrace/file");
+    return file.first ? file.second : std::string{};
+}
+
+/**
+ * Reads the default limit of the ports from the config doc:
+ *
+ *     ports:
+ *       capacity: 10000            # events queued per port, 0 for no limit
+ *       overloadPolicy: dropOldest # dropOldest, dropNewest, keepLatest or block
+ *
+ * @param config The config holding the doc and the error callback.
+ * @return The limit, unbounded if the doc has none.
+ */
+PortLimit readPortLimit(const Config& config)
+{
+    const auto& doc = config.configDoc_;
+    PortLimit   limit;
+    if (auto capacity = doc.getValue<int>("/ports/capacity"); capacity.first) {
+        if (capacity.second < 0) {
+            config.onErrorCallBack_(
+                Error{{6, fmt::format("invalid config value /ports/capacity: '{}'", capacity.second)}});
+        } else {
+            limit.capacity_ = static_cast<std::size_t>(capacity.second);
+        }
+    }
+    if (auto policy = doc.getValue<std::string>("/ports/overloadPolicy"); policy.first) {
+        if (policy.second == "dropOldest") {
+            limit.policy_ = OverloadPolicy::DROP_OLDEST;
+        } else if (policy.second == "dropNewest") {
+            limit.policy_ = OverloadPolicy::DROP_NEWEST;
+        } else if (policy.second == "keepLatest") {
+            limit.policy_ = OverloadPolicy::KEEP_LATEST;
+        } else if (policy.second == "block") {
+            limit.policy_ = OverloadPolicy::BLOCK;
+        } else {
+            config.onErrorCallBack_(
+                Error{{6, fmt::format("invalid config value /ports/overloadPolicy: '{}'", policy.second)}});
+        }
+    }
+    return limit;
+}
+
+} // namespace
 
 Environment::Environment(const ConfigAndLogger& configAndLogger)
     : configAndLogger_(configAndLogger)
 {
+    const auto& config = configAndLogger_.config_;
+    flowTraceFile_     = readFlowTraceSettings(config);
+    portLimit_         = readPortLimit(config);
+
+    // metrics:
+    //   enabled: true        # measure queue depth, latency and service time per actor and message type
+    //   logPeriodMs: 10000   # Core::run() logs the metrics with this period
+    if (auto enabled = config.configDoc_.getValue<bool>("/metrics/enabled"); enabled.first) {
+        metricsEnabled_ = enabled.second;
+    }
+    if (auto period = config.configDoc_.getValue<int>("/metrics/logPeriodMs"); period.first) {
+        metricsLogPeriod_ = std::chrono::milliseconds{std::max(period.second, 0)};
+    }
+
+    priorities_.emplace_back(std::make_unique<Priority>(config.numberOfDispatchers_, config.onErrorCallBack_,
+                                                        readDispatcherSettings(config, "normal")));
+    levelToPriority_.fill(priorities_.front().get());
+
+    auto addLevel = [this, &config](PriorityLevel level, int dispatcherCount, const char* levelName) {
+        if (dispatcherCount > 0) {
+            priorities_.emplace_back(std::make_unique<Priority>(dispatcherCount, config.onErrorCallBack_,
+                                                                readDispatcherSettings(config, levelName)));
+            levelToPriority_[static_cast<std::size_t>(level)] = priorities_.back().get();
+        }
+    };
+    addLevel(PriorityLevel::HIGH, config.highPriorityDispatchers_, "high");
+    addLevel(PriorityLevel::LOW, config.lowPriorityDispatchers_, "low");
+}
+
+Network& Environment::getNetwork(const std::string& name) const
+{
+    if (name == DEFAULT_NETWORK) {
+        return network_;
+    }
+    std::lock_guard<std::mutex> guard{networksMutex_};
+    auto&                       network = networks_[name];
+    if (!network) {
+        network = std::make_unique<Network>();
+    }
+    return *network;
+}
+
+void Environment::startPriorities() const
+{
+    for (const auto& priority : priorities_) {
+        priority->start();
+    }
+}
+
+void Environment::waitForIdle() const
+{
+    while (true) {
+        std::uint64_t scheduledBefore = 0;
+        for (const auto& priority : priorities_) {
+            scheduledBefore += priority->getScheduledCount();
+        }
+        for (const auto& priority : priorities_) {
+            priority->waitForIdle();
+        }
+        std::uint64_t scheduledAfter = 0;
+        for (const auto& priority : priorities_) {
+            scheduledAfter += priority->getScheduledCount();
+        }
+        // nothing was scheduled while waiting, so the priorities idle already stayed idle
+        if (scheduledBefore == scheduledAfter) {
+            return;
+        }
+    }
+}
+
+void Environment::stopPriorities() const
+{
+    for (const auto& priority : priorities_) {
+        priority->stop();
+    }
+}
+
+std::shared_ptr<adst::ep::test_engine::core::impl::MessageCounters> Environment::newMessageCounters(
+    const std::string& actor, const char* type) const
+{
+    if (!metricsEnabled_) {
+        return nullptr;
+    }
+    auto                        counters = std::make_shared<impl::MessageCounters>();
+    std::lock_guard<std::mutex> guard{metricsMutex_};
+    metrics_.push_back({actor, type, counters});
+    return counters;
+}
+
+MetricsSnapshot Environment::collectMetrics() const
+{
+    MetricsSnapshot             metrics;
+    std::lock_guard<std::mutex> guard{metricsMutex_};
+    metrics.reserve(metrics_.size());
+    for (const auto& entry : metrics_) {
+        metrics.push_back(entry.counters_->snapshot(entry.actor_, entry.type_));
+    }
+    return metrics;
 }
@@ -0,0 +1,454 @@
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#if defined(__linux__)
+    #include <pthread.h>
+#endif
+
+#include <fmt/format.h>
+#include "core/impl/flow_trace.hpp"
+
+using adst::ep::test_engine::core::impl::FlowEvent;
+using adst::ep::test_engine::core::impl::FlowRecord;
+using adst::ep::test_engine::core::impl::FlowTrace;
+using adst::ep::test_engine::core::impl::type_index_t;
+
+std::atomic<bool> FlowTrace::enabled_ = {false};
+
+namespace {
+
+constexpr std::array<char, 8> DUMP_MAGIC   = {'R', 'A', 'P', 'I', 'F', 'L', 'O', 'W'};
+constexpr std::uint32_t       DUMP_VERSION = 1;
+
+/**
+ * Single writer ring of one thread. The records are kept as atomic words so the dump can read them
+ * while the owner keeps writing, a record overwritten during the read is detected by the head.
+ */
+class FlowRing
+{
+public:
+    FlowRing(std::size_t capacity, std::string threadName)
+        : threadName_(std::move(threadName))
+        , words_(capacity * WORDS_PER_RECORD)
+        , mask_(capacity - 1)
+    {
+    }
+
+    void write(const FlowRecord& record)
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        auto*      word = &words_[(head & mask_) * WORDS_PER_RECORD];
+        word[0].store(record.timestamp_, std::memory_order_relaxed);
+        word[1].store(record.typeIndex_ | (static_cast<std::uint64_t>(record.actorId_) << 32U),
+                      std::memory_order_relaxed);
+        word[2].store(static_cast<std::uint64_t>(record.event_), std::memory_order_relaxed);
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * @return The records still in the ring, the oldest first.
+     */
+    std::vector<FlowRecord> read() const
+    {
+        const std::uint64_t capacity = mask_ + 1;
+        const auto          head     = head_.load(std::memory_order_acquire);
+        const auto          first    = head > capacity ? head - capacity : 0;
+
+        std::vector<FlowRecord> records;
+        records.reserve(head - first);
+        for (auto index = first; index < head; ++index) {
+            const auto* word  = &words_[(index & mask_) * WORDS_PER_RECORD];
+            const auto  types = word[1].load(std::memory_order_relaxed);
+            records.push_back({word[0].load(std::memory_order_relaxed), static_cast<type_index_t>(types),
+                               static_cast<std::uint32_t>(types >> 32U),
+                               static_cast<FlowEvent>(word[2].load(std::memory_order_relaxed))});
+        }
+
+        // the writer may have lapped the reader, drop what could have been overwritten meanwhile
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto after = head_.load(std::memory_order_relaxed);
+        const auto valid = after > capacity ? after - capacity : 0;
+        if (valid > first) {
+            records.erase(records.begin(), records.begin() + static_cast<std::ptrdiff_t>(
+                                                                 std::min<std::uint64_t>(valid - first, records.size())));
+        }
+        return records;
+    }
+
+    const std::string& getThreadName() const
+    {
+        return threadName_;
+    }
+
+private:
+    static constexpr std::size_t WORDS_PER_RECORD = 3;
+
+    const std::string                       threadName_;
+    std::vector<std::atomic<std::uint64_t>> words_;
+    const std::uint64_t                     mask_;
+    std::atomic<std::uint64_t>              head_ = {0}; /// number of records ever written
+};
+
+/**
+ * The rings and the names, only touched on the cold paths.
+ */
+struct Registry
+{
+    std::mutex                              mutex_;
+    std::size_t                             capacity_ = FlowTrace::DEFAULT_CAPACITY;
+    std::vector<std::shared_ptr<FlowRing>>  rings_;  /// rings of all threads ever recorded, kept for dump
+    std::map<type_index_t, std::string>     types_;  /// message type names by type index
+    std::vector<std::string>                actors_; /// actor names by actor id
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+/**
+ * @return The ring of the calling thread, created on the first record.
+ */
+FlowRing& threadRing()
+{
+    thread_local std::shared_ptr<FlowRing> ring;
+    if (ring == nullptr) {
+        std::string name;
+#if defined(__linux__)
+        std::array<char, 16> threadName = {};
+        if (pthread_getname_np(pthread_self(), threadName.data(), threadName.size()) == 0) {
+            name = threadName.data();
+        }
+#endif
+        auto&                       reg = registry();
+        std::lock_guard<std::mutex> guard{reg.mutex_};
+        name = fmt::format("{}#{}", name.empty() ? "thread" : name, reg.rings_.size());
+        ring = std::make_shared<FlowRing>(reg.capacity_, std::move(name));
+        reg.rings_.push_back(ring);
+    }
+    return *ring;
+}
+
+template <typename T>
+void put(std::ostream& out, T value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void put(std::ostream& out, const std::string& value)
+{
+    put(out, static_cast<std::uint32_t>(value.size()));
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+template <typename T>
+bool get(std::istream& in, T& value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+bool get(std::istream& in, std::string& value)
+{
+    std::uint32_t size = 0;
+    if (!get(in, size)) {
+        return false;
+    }
+    value.resize(size);
+    return static_cast<bool>(in.read(value.data(), size));
+}
+
+/**
+ * A dump read back, see FlowTrace::dump() for the layout.
+ */
+struct Dump
+{
+    struct Thread
+    {
+        std::string             name_;
+        std::vector<FlowRecord> records_;
+    };
+
+    std::map<type_index_t, std::string> types_;
+    std::vector<std::string>            actors_;
+    std::vector<Thread>                 threads_;
+
+    const std::string& typeName(type_index_t typeIndex) const
+    {
+        static const std::string unknown = "?";
+        auto                     type    = types_.find(typeIndex);
+        return type == types_.end() ? unknown : type->second;
+    }
+
+    const std::string& actorName(std::uint32_t actorId) const
+    {
+        static const std::string unknown = "?";
+        return actorId < actors_.size() ? actors_[actorId] : unknown;
+    }
+
+    /**
+     * @return The earliest timestamp, the decoders show the time relative to it.
+     */
+    std::uint64_t start() const
+    {
+        auto start = std::numeric_limits<std::uint64_t>::max();
+        for (const auto& thread : threads_) {
+            if (!thread.records_.empty()) {
+                start = std::min(start, thread.records_.front().timestamp_);
+            }
+        }
+        return start;
+    }
+};
+
+bool readDump(std::istream& in, Dump& dump)
+{
+    std::array<char, DUMP_MAGIC.size()> magic   = {};
+    std::uint32_t                       version = 0;
+    if (!in.read(magic.data(), magic.size()) || magic != DUMP_MAGIC || !get(in, version) || version != DUMP_VERSION) {
+        return false;
+    }
+
+    std::uint32_t count = 0;
+    if (!get(in, count)) {
+        return false;
+    }
+    for (std::uint32_t index = 0; index < count; ++index) {
+        type_index_t typeIndex = 0;
+        std::string  name;
+        if (!get(in, typeIndex) || !get(in, name)) {
+            return false;
+        }
+        dump.types_[typeIndex] = std::move(name);
+    }
+
+    if (!get(in, count)) {
+        return false;
+    }
+    dump.actors_.resize(count);
+    for (auto& actor : dump.actors_) {
+        if (!get(in, actor)) {
+            return false;
+        }
+    }
+
+    if (!get(in, count)) {
+        return false;
+    }
+    dump.threads_.resize(count);
+    for (auto& thread : dump.threads_) {
+        std::uint64_t records = 0;
+        if (!get(in, thread.name_) || !get(in, records)) {
+            return false;
+        }
+        thread.records_.resize(records);
+        for (auto& record : thread.records_) {
+            if (!get(in, record.timestamp_) || !get(in, record.typeIndex_) || !get(in, record.actorId_) ||
+                !get(in, record.event_)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+const char* eventName(FlowEvent event)
+{
+    switch (event) {
+        case FlowEvent::PUBLISH:
+            return "PUBLISH";
+        case FlowEvent::QUEUE:
+            return "QUEUE";
+        case FlowEvent::DISPATCH_BEGIN:
+            return "DISPATCH_BEGIN";
+        case FlowEvent::DISPATCH_END:
+            return "DISPATCH_END";
+        default:
+            return "?";
+    }
+}
+
+/**
+ * @return value as JSON string content.
+ */
+std::string jsonEscape(const std::string& value)
+{
+    std::string escaped;
+    for (const char character : value) {
+        if (character == '"' || character == '\\') {
+            escaped += '\\';
+        }
+        if (static_cast<unsigned char>(character) < 0x20) {
+            escaped += fmt::format("\\u{:04x}", character);
+        } else {
+            escaped += character;
+        }
+    }
+    return escaped;
+}
+
+} // namespace
+
+void FlowTrace::enable(std::size_t capacity)
+{
+    std::size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1U;
+    }
+    {
+        auto&                       reg = registry();
+        std::lock_guard<std::mutex> guard{reg.mutex_};
+        reg.capacity_ = rounded;
+    }
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void FlowTrace::disable()
+{
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+std::uint32_t FlowTrace::registerActor(const std::string& name)
+{
+    auto&                       reg = registry();
+    std::lock_guard<std::mutex> guard{reg.mutex_};
+    reg.actors_.push_back(name);
+    return static_cast<std::uint32_t>(reg.actors_.size() - 1);
+}
+
+bool FlowTrace::registerType(type_index_t typeIndex, const char* name)
+{
+    auto&                       reg = registry();
+    std::lock_guard<std::mutex> guard{reg.mutex_};
+    reg.types_[typeIndex] = name;
+    return true;
+}
+
+void FlowTrace::write(const FlowRecord& record)
+{
+    threadRing().write(record);
+}
+
+void FlowTrace::dump(std::ostream& out)
+{
+    auto&                                  reg = registry();
+    std::vector<std::shared_ptr<FlowRing>> rings;
+
+    out.write(DUMP_MAGIC.data(), DUMP_MAGIC.size());
+    put(out, DUMP_VERSION);
+    {
+        std::lock_guard<std::mutex> guard{reg.mutex_};
+        put(out, static_cast<std::uint32_t>(reg.types_.size()));
+        for (const auto& type : reg.types_) {
+            put(out, type.first);
+            put(out, type.second);
+        }
+        put(out, static_cast<std::uint32_t>(reg.actors_.size()));
+        for (const auto& actor : reg.actors_) {
+            put(out, actor);
+        }
+        rings = reg.rings_;
+    }
+
+    // the records are written in host byte order, the dump is decoded on the same kind of machine
+    put(out, static_cast<std::uint32_t>(rings.size()));
+    for (const auto& ring : rings) {
+        const auto records = ring->read();
+        put(out, ring->getThreadName());
+        put(out, static_cast<std::uint64_t>(records.size()));
+        for (const auto& record : records) {
+            put(out, record.timestamp_);
+            put(out, record.typeIndex_);
+            put(out, record.actorId_);
+            put(out, record.event_);
+        }
+    }
+}
+
+bool FlowTrace::dump(const std::string& fileName)
+{
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    dump(out);
+    return static_cast<bool>(out);
+}
+
+bool FlowTrace::decodeText(std::istream& in, std::ostream& out)
+{
+    Dump dump;
+    if (!readDump(in, dump)) {
+        return false;
+    }
+
+    struct Line
+    {
+        const FlowRecord*  record_;
+        const std::string* thread_;
+    };
+    std::vector<Line> lines;
+    for (const auto& thread : dump.threads_) {
+        for (const auto& record : thread.records_) {
+            lines.push_back({&record, &thread.name_});
+        }
+    }
+    std::stable_sort(lines.begin(), lines.end(), [](const Line& left, const Line& right) {
+        return left.record_->timestamp_ < right.record_->timestamp_;
+    });
+
+    const auto start = dump.start();
+    for (const auto& line : lines) {
+        const auto& record = *line.record_;
+        out << fmt::format("{:>14.3f}us [{}] {:<14} {} {}\n", static_cast<double>(record.timestamp_ - start) / 1000.0,
+                           *line.thread_, eventName(record.event_), dump.actorName(record.actorId_),
+                           dump.typeName(record.typeIndex_));
+    }
+    return static_cast<bool>(out);
+}
+
+bool FlowTrace::decodeChromeTrace(std::istream& in, std::ostream& out)
+{
+    Dump dump;
+    if (!readDump(in, dump)) {
+        return false;
+    }
+
+    const auto start = dump.start();
+    const char* separator = "\n";
+    out << "{\"traceEvents\":[";
+    for (std::size_t tid = 0; tid < dump.threads_.size(); ++tid) {
+        const auto& thread = dump.threads_[tid];
+        out << separator
+            << fmt::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}})", tid,
+                           jsonEscape(thread.name_));
+        separator = ",\n";
+        for (const auto& record : thread.records_) {
+            const char* phase = "i";
+            std::string name  = jsonEscape(dump.typeName(record.typeIndex_));
+            switch (record.event_) {
+                case FlowEvent::DISPATCH_BEGIN:
+                    phase = "B";
+                    break;
+                case FlowEvent::DISPATCH_END:
+                    phase = "E";
+                    break;
+                case FlowEvent::PUBLISH:
+                    name = "publish " + name;
+                    break;
+                default:
+                    name = "queue " + name;
+                    break;
+            }
+            out << separator
+                << fmt::format(
+                       R"({{"name":"{}","cat":"flow","ph":"{}",{}"ts":{:.3f},"pid":1,"tid":{},"args":{{"actor":"{}"}}}})",
+                       name, phase, *phase == 'i' ? R"("s":"t",)" : "", static_cast<double>(record.timestamp_ - start) / 1000.0, tid,
+                       jsonEscape(dump.actorName(record.actorId_)));
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,255 @@
+#include "core/impl/io_engine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#if defined(__linux__)
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+#include <fmt/format.h>
+
+using Error           = adst::common::Error;
+using IoBackend       = adst::ep::test_engine::core::IoBackend;
+using IoEngine        = adst::ep::test_engine::core::impl::IoEngine;
+using IoReceiver      = adst::ep::test_engine::core::impl::IoReceiver;
+using OnErrorCallBack = adst::common::OnErrorCallBack;
+
+std::unique_ptr<IoEngine> IoEngine::create(IoBackend backend, int bufferCount, int bufferSize,
+                                           const OnErrorCallBack& onError, std::string& report)
+{
+#if defined(__linux__)
+    std::string reason;
+    if (backend == IoBackend::IO_URING) {
+        if (auto engine = makeIoUringEngine(bufferCount, bufferSize, onError, reason)) {
+            report = " io=io_uring";
+            return engine;
+        }
+        report = fmt::format(" io=epoll (io_uring: {})", reason);
+    } else {
+        report = " io=epoll";
+    }
+    auto engine = makeEpollEngine(bufferCount, bufferSize, onError, reason);
+    if (!engine) {
+        onError(Error{{3, fmt::format("I/O engine: {}", reason)}});
+    }
+    return engine;
+#else
+    (void)backend;
+    (void)bufferCount;
+    (void)bufferSize;
+    (void)onError;
+    report = " io=none (not supported on this platform)";
+    return nullptr;
+#endif
+}
+
+#if defined(__linux__)
+
+namespace {
+
+constexpr int MAX_EVENTS = 64; /// events taken by one epoll_wait
+
+/**
+ * A socket of the epoll engine with the buffers of its recvmmsg.
+ */
+struct EpollReceiver final : public IoReceiver
+{
+    EpollReceiver(int fd, OnBatch onBatch, std::size_t bufferCount, std::size_t bufferSize)
+        : IoReceiver(fd, std::move(onBatch))
+        , buffer_(bufferCount * bufferSize)
+        , headers_(bufferCount)
+        , vectors_(bufferCount)
+        , peers_(bufferCount)
+    {
+        for (std::size_t index = 0; index < bufferCount; ++index) {
+            vectors_[index]                    = {buffer_.data() + index * bufferSize, bufferSize};
+            headers_[index].msg_hdr.msg_name   = &peers_[index];
+            headers_[index].msg_hdr.msg_iov    = &vectors_[index];
+            headers_[index].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    std::vector<std::uint8_t> buffer_;       /// the datagrams of the last recvmmsg
+    std::vector<mmsghdr>      headers_;      /// recvmmsg arguments, point into buffer_
+    std::vector<iovec>        vectors_;      /// one per datagram
+    std::vector<sockaddr_in>  peers_;        /// the senders
+    bool                      full_ = false; /// the last recvmmsg filled all buffers, the socket might have more
+};
+
+/**
+ * Waits with epoll and reads a receiver with one recvmmsg per wake-up. The sockets are armed one
+ * shot, a receiver holding a batch is armed again when it is released.
+ */
+class EpollEngine final : public IoEngine
+{
+public:
+    EpollEngine(int epollFd, int wakeFd, std::size_t bufferCount, std::size_t bufferSize,
+                const OnErrorCallBack& onError)
+        : epollFd_(epollFd)
+        , wakeFd_(wakeFd)
+        , bufferCount_(bufferCount)
+        , bufferSize_(bufferSize)
+        , onError_(onError)
+    {
+    }
+
+    // not copyable or movable
+    EpollEngine(const EpollEngine&) = delete;
+    EpollEngine(EpollEngine&&)      = delete;
+
+    EpollEngine& operator=(const EpollEngine&) = delete;
+    EpollEngine& operator=(EpollEngine&&) = delete;
+
+    ~EpollEngine() override
+    {
+        ::close(wakeFd_);
+        ::close(epollFd_);
+    }
+
+    IoReceiver& addReceiver(int fd, IoReceiver::OnBatch onBatch) override
+    {
+        receivers_.push_back(std::make_unique<EpollReceiver>(fd, std::move(onBatch), bufferCount_, bufferSize_));
+        auto& receiver = *receivers_.back();
+        arm(receiver, EPOLL_CTL_ADD);
+        return receiver;
+    }
+
+    void removeReceiver(IoReceiver& receiver) override
+    {
+        // the socket might already be closed, which removed it from the epoll set
+        ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, receiver.fd_, nullptr);
+        receivers_.erase(std::find_if(receivers_.begin(), receivers_.end(),
+                                      [&receiver](const auto& owned) { return owned.get() == &receiver; }));
+    }
+
+    void release(IoReceiver& receiver) override
+    {
+        auto& epollReceiver = static_cast<EpollReceiver&>(receiver);
+        epollReceiver.held_ = false;
+        epollReceiver.datagrams_.clear();
+        // a full batch most likely left datagrams in the socket, read them without asking epoll
+        if (!epollReceiver.full_ || !read(epollReceiver)) {
+            arm(epollReceiver, EPOLL_CTL_MOD);
+        }
+    }
+
+    bool poll(bool wait) override
+    {
+        std::array<epoll_event, MAX_EVENTS> events = {};
+        const int count = ::epoll_wait(epollFd_, events.data(), MAX_EVENTS, wait ? -1 : 0);
+        if (count < 0) {
+            if (errno != EINTR) {
+                onError_(Error{{3, fmt::format("I/O engine: epoll_wait failed: {}", std::strerror(errno))}});
+            }
+            return false;
+        }
+        for (int index = 0; index < count; ++index) {
+            if (events[index].data.ptr == nullptr) {
+                std::uint64_t value = 0;
+                (void)!::read(wakeFd_, &value, sizeof(value));
+                continue;
+            }
+            auto& receiver = *static_cast<EpollReceiver*>(events[index].data.ptr);
+            if (!read(receiver)) {
+                arm(receiver, EPOLL_CTL_MOD);
+            }
+        }
+        return count > 0;
+    }
+
+    void wake() override
+    {
+        const std::uint64_t one = 1;
+        (void)!::write(wakeFd_, &one, sizeof(one));
+    }
+
+private:
+    void arm(EpollReceiver& receiver, int operation)
+    {
+        epoll_event event = {};
+        event.events      = EPOLLIN | EPOLLONESHOT;
+        event.data.ptr    = &receiver;
+        if (::epoll_ctl(epollFd_, operation, receiver.fd_, &event) != 0) {
+            onError_(Error{{3, fmt::format("I/O engine: epoll_ctl of socket {} failed: {}", receiver.fd_,
+                                           std::strerror(errno))}});
+        }
+    }
+
+    /**
+     * Reads the socket and hands the datagrams out.
+     * @return False if there was nothing to read, the receiver shall be armed again.
+     */
+    bool read(EpollReceiver& receiver)
+    {
+        for (auto& header : receiver.headers_) {
+            header.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        }
+        const int count =
+            ::recvmmsg(receiver.fd_, receiver.headers_.data(), static_cast<unsigned>(bufferCount_), MSG_DONTWAIT, nullptr);
+        if (count <= 0) {
+            // errors of the socket itself (e.g. ECONNREFUSED after an ICMP) are gone with the next read
+            if (count < 0 && (errno == EBADF || errno == ENOTSOCK)) {
+                onError_(Error{{3, fmt::format("I/O engine: recvmmsg of socket {} failed: {}", receiver.fd_,
+                                               std::strerror(errno))}});
+            }
+            return false;
+        }
+        receiver.datagrams_.clear();
+        for (int index = 0; index < count; ++index) {
+            const auto& header = receiver.headers_[index];
+            const auto& peer   = receiver.peers_[index];
+            receiver.datagrams_.push_back({static_cast<const std::uint8_t*>(receiver.vectors_[index].iov_base),
+                                           header.msg_len, ntohl(peer.sin_addr.s_addr), ntohs(peer.sin_port),
+                                           (header.msg_hdr.msg_flags & MSG_TRUNC) != 0});
+        }
+        receiver.full_ = static_cast<std::size_t>(count) == bufferCount_;
+        receiver.held_ = true;
+        receiver.onBatch_(receiver);
+        return true;
+    }
+
+    const int                                   epollFd_;
+    const int                                   wakeFd_; /// eventfd registered with a null pointer
+    const std::size_t                           bufferCount_;
+    const std::size_t                           bufferSize_;
+    const OnErrorCallBack&                      onError_;
+    std::vector<std::unique_ptr<EpollReceiver>> receivers_ = {};
+};
+
+} // namespace
+
+std::unique_ptr<IoEngine> adst::ep::test_engine::core::impl::makeEpollEngine(int bufferCount, int bufferSize,
+                                                                             const OnErrorCallBack& onError,
+                                                                             std::string& reason)
+{
+    const int epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        reason = fmt::format("epoll_create1 failed: {}", std::strerror(errno));
+        return nullptr;
+    }
+    const int wakeFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    epoll_event event = {};
+    event.events      = EPOLLIN;
+    event.data.ptr    = nullptr;
+    if (wakeFd < 0 || ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) != 0) {
+        reason = fmt::format("eventfd failed: {}", std::strerror(errno));
+        if (wakeFd >= 0) {
+            ::close(wakeFd);
+        }
+        ::close(epollFd);
+        return nullptr;
+    }
+    return std::make_unique<EpollEngine>(epollFd, wakeFd, static_cast<std::size_t>(bufferCount),
+                                         static_cast<std::size_t>(bufferSize), onError);
+}
+
+#endif
@@ -0,0 +1,495 @@
+#include "core/impl/io_engine.hpp"
+
+#if defined(__linux__)
+
+    #include <algorithm>
+    #include <cerrno>
+    #include <cstring>
+    #include <vector>
+
+    #include <arpa/inet.h>
+    #include <linux/io_uring.h>
+    #include <netinet/in.h>
+    #include <sys/eventfd.h>
+    #include <sys/mman.h>
+    #include <sys/socket.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+
+    #include <fmt/format.h>
+
+using Error           = adst::common::Error;
+using IoEngine        = adst::ep::test_engine::core::impl::IoEngine;
+using IoReceiver      = adst::ep::test_engine::core::impl::IoReceiver;
+using OnErrorCallBack = adst::common::OnErrorCallBack;
+
+namespace {
+
+constexpr unsigned      QUEUE_DEPTH  = 256;     /// submission queue entries, the completion queue gets twice as many
+constexpr unsigned      MAX_BUFFERS  = 1 << 15; /// limit of a provided buffer ring
+constexpr std::uint64_t WAKE_TAG     = 1;       /// user data of the read of the eventfd
+constexpr std::uint64_t CANCEL_TAG   = 2;       /// user data of the cancellation of a receiver
+constexpr std::uint16_t BUFFER_GROUP = 0;       /// the one provided buffer ring of the engine
+
+// the raw system calls, liburing is not needed for the few operations used
+int ioUringSetup(unsigned entries, io_uring_params& params)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+}
+
+int ioUringEnter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int ringFd, unsigned opcode, void* argument, unsigned count)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, ringFd, opcode, argument, count));
+}
+
+// the rings are shared with the kernel, head and tail are handed over with acquire and release
+template <typename T>
+T loadAcquire(const T* value)
+{
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+template <typename T>
+void storeRelease(T* value, T newValue)
+{
+    __atomic_store_n(value, newValue, __ATOMIC_RELEASE);
+}
+
+/**
+ * A socket of the io_uring engine. While armed_ a multishot recvmsg picks a provided buffer for
+ * each datagram and posts a completion for it.
+ */
+struct UringReceiver final : public IoReceiver
+{
+    using IoReceiver::IoReceiver;
+
+    /**
+     * A provided buffer filled by the kernel.
+     */
+    struct Filled
+    {
+        std::uint16_t buffer_; /// id of the buffer
+        std::uint32_t size_;   /// bytes written, recvmsg header and sender address included
+    };
+
+    msghdr                     msg_       = {};    /// template of the multishot recvmsg
+    bool                       armed_     = false; /// the multishot recvmsg is in flight
+    bool                       removed_   = false; /// waiting for the kernel to let go before it is freed
+    std::vector<Filled>        filled_    = {};    /// received, not yet handed out
+    std::vector<std::uint16_t> handedOut_ = {};    /// the buffers of datagrams_
+};
+
+/**
+ * One ring per dispatcher with a ring of provided buffers shared by all its receivers. The ring is
+ * set up single issuer with deferred task work, the kernel only does the completion work when the
+ * dispatcher asks for completions.
+ */
+class IoUringEngine final : public IoEngine
+{
+public:
+    IoUringEngine(unsigned bufferCount, std::size_t bufferSize, const OnErrorCallBack& onError)
+        : bufferCount_(bufferCount)
+        , bufferSize_(bufferSize)
+        , onError_(onError)
+    {
+    }
+
+    // not copyable or movable
+    IoUringEngine(const IoUringEngine&) = delete;
+    IoUringEngine(IoUringEngine&&)      = delete;
+
+    IoUringEngine& operator=(const IoUringEngine&) = delete;
+    IoUringEngine& operator=(IoUringEngine&&) = delete;
+
+    ~IoUringEngine() override
+    {
+        // closing the ring cancels what is in flight
+        if (ringFd_ >= 0) {
+            ::close(ringFd_);
+        }
+        if (ring_ != MAP_FAILED) {
+            ::munmap(ring_, ringSize_);
+        }
+        if (sqes_ != MAP_FAILED) {
+            ::munmap(sqes_, sqesSize_);
+        }
+        if (bufferRing_ != MAP_FAILED) {
+            ::munmap(bufferRing_, bufferRingSize_);
+        }
+        if (wakeFd_ >= 0) {
+            ::close(wakeFd_);
+        }
+    }
+
+    /**
+     * Creates the ring and registers the buffers.
+     * @param reason Set to what is missing on failure.
+     * @return False if the kernel does not support what is needed.
+     */
+    bool setUp(std::string& reason)
+    {
+        io_uring_params params = {};
+        params.flags           = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+        ringFd_                = ioUringSetup(QUEUE_DEPTH, params);
+        if (ringFd_ < 0 && errno == EINVAL) {
+            params  = {}; // kernels before 6.1
+            ringFd_ = ioUringSetup(QUEUE_DEPTH, params);
+        }
+        if (ringFd_ < 0) {
+            reason = fmt::format("io_uring_setup failed: {}", std::strerror(errno));
+            return false;
+        }
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0 || (params.features & IORING_FEAT_NODROP) == 0) {
+            reason = "kernel too old";
+            return false;
+        }
+        deferTaskRun_ = (params.flags & IORING_SETUP_DEFER_TASKRUN) != 0;
+
+        ringSize_ = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                             params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+        ring_     = ::mmap(nullptr, ringSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_,
+                           IORING_OFF_SQ_RING);
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_     = static_cast<io_uring_sqe*>(::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+                                                      MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES));
+        if (ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+            reason = fmt::format("mmap of the ring failed: {}", std::strerror(errno));
+            return false;
+        }
+        auto* const ring = static_cast<std::uint8_t*>(ring_);
+        sqHead_          = reinterpret_cast<const unsigned*>(ring + params.sq_off.head); // NOLINT
+        sqTail_          = reinterpret_cast<unsigned*>(ring + params.sq_off.tail);       // NOLINT
+        sqMask_          = *reinterpret_cast<const unsigned*>(ring + params.sq_off.ring_mask); // NOLINT
+        sqEntries_       = params.sq_entries;
+        cqHead_          = reinterpret_cast<unsigned*>(ring + params.cq_off.head);       // NOLINT
+        cqTail_          = reinterpret_cast<const unsigned*>(ring + params.cq_off.tail); // NOLINT
+        cqMask_          = *reinterpret_cast<const unsigned*>(ring + params.cq_off.ring_mask); // NOLINT
+        cqes_            = reinterpret_cast<const io_uring_cqe*>(ring + params.cq_off.cqes);   // NOLINT
+        auto* const array = reinterpret_cast<unsigned*>(ring + params.sq_off.array);           // NOLINT
+        for (unsigned index = 0; index < sqEntries_; ++index) {
+            array[index] = index; // the entries are used in ring order
+        }
+        sqLocalTail_ = *sqTail_;
+
+        bufferRingSize_ = bufferCount_ * sizeof(io_uring_buf);
+        bufferRing_     = static_cast<io_uring_buf_ring*>(
+            ::mmap(nullptr, bufferRingSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (bufferRing_ == MAP_FAILED) {
+            reason = fmt::format("mmap of the buffer ring failed: {}", std::strerror(errno));
+            return false;
+        }
+        io_uring_buf_reg registration = {};
+        registration.ring_addr        = reinterpret_cast<std::uint64_t>(bufferRing_); // NOLINT
+        registration.ring_entries     = bufferCount_;
+        registration.bgid             = BUFFER_GROUP;
+        if (ioUringRegister(ringFd_, IORING_REGISTER_PBUF_RING, &registration, 1) != 0) {
+            reason = fmt::format("provided buffer ring failed: {}", std::strerror(errno));
+            return false;
+        }
+        buffers_.resize(bufferCount_ * bufferSize_);
+        for (unsigned buffer = 0; buffer < bufferCount_; ++buffer) {
+            recycle(static_cast<std::uint16_t>(buffer));
+        }
+        publishBuffers();
+
+        wakeFd_ = ::eventfd(0, EFD_CLOEXEC);
+        if (wakeFd_ < 0) {
+            reason = fmt::format("eventfd failed: {}", std::strerror(errno));
+            return false;
+        }
+        armWake();
+        return true;
+    }
+
+    IoReceiver& addReceiver(int fd, IoReceiver::OnBatch onBatch) override
+    {
+        receivers_.push_back(std::make_unique<UringReceiver>(fd, std::move(onBatch)));
+        auto& receiver               = *receivers_.back();
+        receiver.msg_.msg_namelen    = sizeof(sockaddr_in);
+        receiver.msg_.msg_controllen = 0;
+        arm(receiver);
+        return receiver;
+    }
+
+    void removeReceiver(IoReceiver& receiver) override
+    {
+        auto& uringReceiver    = static_cast<UringReceiver&>(receiver);
+        uringReceiver.onBatch_ = nullptr;
+        uringReceiver.removed_ = true;
+        uringReceiver.held_    = false;
+        uringReceiver.datagrams_.clear();
+        for (const auto buffer : uringReceiver.handedOut_) {
+            recycle(buffer);
+        }
+        for (const auto& filled : uringReceiver.filled_) {
+            recycle(filled.buffer_);
+        }
+        uringReceiver.handedOut_.clear();
+        uringReceiver.filled_.clear();
+        publishBuffers();
+        if (!uringReceiver.armed_) {
+            erase(uringReceiver);
+            return;
+        }
+        // freed with the last completion of the multishot recvmsg
+        auto& sqe     = nextSqe();
+        sqe.opcode    = IORING_OP_ASYNC_CANCEL;
+        sqe.fd        = -1;
+        sqe.addr      = reinterpret_cast<std::uint64_t>(&uringReceiver); // NOLINT
+        sqe.user_data = CANCEL_TAG;
+    }
+
+    void release(IoReceiver& receiver) override
+    {
+        auto& uringReceiver = static_cast<UringReceiver&>(receiver);
+        for (const auto buffer : uringReceiver.handedOut_) {
+            recycle(buffer);
+        }
+        uringReceiver.handedOut_.clear();
+        uringReceiver.datagrams_.clear();
+        uringReceiver.held_ = false;
+        publishBuffers();
+        if (!uringReceiver.filled_.empty()) {
+            handOut(uringReceiver);
+        }
+    }
+
+    bool poll(bool wait) override
+    {
+        const unsigned toSubmit = sqLocalTail_ - loadAcquire(sqHead_);
+        unsigned       flags    = 0;
+        unsigned       minimum  = 0;
+        if (wait && loadAcquire(cqTail_) == *cqHead_) {
+            flags   = IORING_ENTER_GETEVENTS;
+            minimum = 1;
+        } else if (deferTaskRun_) {
+            flags = IORING_ENTER_GETEVENTS; // the completions are only posted when asked for
+        }
+        if ((toSubmit > 0 || flags != 0) && ioUringEnter(ringFd_, toSubmit, minimum, flags) < 0 && errno != EINTR &&
+            errno != EAGAIN && errno != EBUSY) {
+            onError_(Error{{3, fmt::format("I/O engine: io_uring_enter failed: {}", std::strerror(errno))}});
+        }
+
+        const unsigned first = *cqHead_;
+        const unsigned last  = loadAcquire(cqTail_);
+        for (unsigned head = first; head != last; ++head) {
+            complete(cqes_[head & cqMask_]);
+        }
+        storeRelease(cqHead_, last);
+        for (auto* receiver : ready_) {
+            if (!receiver->held_ && !receiver->filled_.empty()) {
+                handOut(*receiver);
+            }
+        }
+        ready_.clear();
+        publishBuffers();
+        return first != last;
+    }
+
+    void wake() override
+    {
+        const std::uint64_t one = 1;
+        (void)!::write(wakeFd_, &one, sizeof(one));
+    }
+
+private:
+    /**
+     * @return The next free submission, submits the queue first if it is full.
+     */
+    io_uring_sqe& nextSqe()
+    {
+        const unsigned pending = sqLocalTail_ - loadAcquire(sqHead_);
+        if (pending >= sqEntries_) {
+            ioUringEnter(ringFd_, pending, 0, 0);
+        }
+        auto& sqe = sqes_[sqLocalTail_ & sqMask_];
+        sqe       = {};
+        storeRelease(sqTail_, ++sqLocalTail_);
+        return sqe;
+    }
+
+    void arm(UringReceiver& receiver)
+    {
+        auto& sqe     = nextSqe();
+        sqe.opcode    = IORING_OP_RECVMSG;
+        sqe.fd        = receiver.fd_;
+        sqe.addr      = reinterpret_cast<std::uint64_t>(&receiver.msg_); // NOLINT
+        sqe.len       = 1;
+        sqe.ioprio    = IORING_RECV_MULTISHOT;
+        sqe.flags     = IOSQE_BUFFER_SELECT;
+        sqe.buf_group = BUFFER_GROUP;
+        sqe.user_data = reinterpret_cast<std::uint64_t>(&receiver); // NOLINT
+        receiver.armed_ = true;
+    }
+
+    void armWake()
+    {
+        auto& sqe     = nextSqe();
+        sqe.opcode    = IORING_OP_READ;
+        sqe.fd        = wakeFd_;
+        sqe.addr      = reinterpret_cast<std::uint64_t>(&wakeValue_); // NOLINT
+        sqe.len       = sizeof(wakeValue_);
+        sqe.user_data = WAKE_TAG;
+    }
+
+    /**
+     * Queues a buffer on the provided buffer ring, the kernel sees it after publishBuffers().
+     */
+    void recycle(std::uint16_t buffer)
+    {
+        // not bufs[], the flexible array of the kernel header is misplaced by 8 bytes when compiled as C++
+        auto& entry = reinterpret_cast<io_uring_buf*>(bufferRing_)[bufferTail_ & (bufferCount_ - 1)]; // NOLINT
+        entry.addr  = reinterpret_cast<std::uint64_t>(buffers_.data() + buffer * bufferSize_); // NOLINT
+        entry.len   = static_cast<std::uint32_t>(bufferSize_);
+        entry.bid   = buffer;
+        ++bufferTail_;
+    }
+
+    /**
+     * Hands the recycled buffers to the kernel and arms the receivers which ran out of buffers.
+     */
+    void publishBuffers()
+    {
+        if (bufferTail_ == publishedTail_) {
+            return;
+        }
+        storeRelease(&bufferRing_->tail, bufferTail_);
+        publishedTail_ = bufferTail_;
+        for (auto* receiver : starved_) {
+            if (!receiver->armed_ && !receiver->removed_) {
+                arm(*receiver);
+            }
+        }
+        starved_.clear();
+    }
+
+    void complete(const io_uring_cqe& cqe)
+    {
+        if (cqe.user_data == WAKE_TAG) {
+            armWake();
+            return;
+        }
+        if (cqe.user_data == CANCEL_TAG) {
+            return;
+        }
+        auto& receiver = *reinterpret_cast<UringReceiver*>(cqe.user_data); // NOLINT
+        if ((cqe.flags & IORING_CQE_F_BUFFER) != 0) {
+            const auto buffer = static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            if (cqe.res > 0 && !receiver.removed_) {
+                if (receiver.filled_.empty()) {
+                    ready_.push_back(&receiver);
+                }
+                receiver.filled_.push_back({buffer, static_cast<std::uint32_t>(cqe.res)});
+            } else {
+                recycle(buffer);
+            }
+        }
+        if ((cqe.flags & IORING_CQE_F_MORE) != 0) {
+            return;
+        }
+        receiver.armed_ = false;
+        if (receiver.removed_) {
+            erase(receiver);
+        } else if (cqe.res == -ENOBUFS) {
+            starved_.push_back(&receiver); // armed again when buffers come back
+        } else if (cqe.res == -EBADF || cqe.res == -ENOTSOCK || cqe.res == -EINVAL) {
+            onError_(Error{{3, fmt::format("I/O engine: multishot recvmsg of socket {} failed: {}", receiver.fd_,
+                                           std::strerror(-cqe.res))}});
+        } else {
+            arm(receiver); // e.g. the completion queue overflowed, or an error of the socket itself
+        }
+    }
+
+    void handOut(UringReceiver& receiver)
+    {
+        // each buffer: io_uring_recvmsg_out, room for the address, the payload
+        const std::size_t header = sizeof(io_uring_recvmsg_out) + receiver.msg_.msg_namelen;
+        receiver.datagrams_.clear();
+        for (const auto& filled : receiver.filled_) {
+            receiver.handedOut_.push_back(filled.buffer_);
+            const std::uint8_t* bytes = buffers_.data() + filled.buffer_ * bufferSize_;
+            io_uring_recvmsg_out out  = {};
+            std::memcpy(&out, bytes, sizeof(out));
+            if (filled.size_ < header) {
+                continue;
+            }
+            sockaddr_in peer = {};
+            if (out.namelen >= sizeof(peer)) {
+                std::memcpy(&peer, bytes + sizeof(out), sizeof(peer));
+            }
+            const std::size_t available = filled.size_ - header;
+            receiver.datagrams_.push_back({bytes + header, std::min<std::size_t>(out.payloadlen, available),
+                                           ntohl(peer.sin_addr.s_addr), ntohs(peer.sin_port),
+                                           (out.flags & MSG_TRUNC) != 0 || out.payloadlen > available});
+        }
+        receiver.filled_.clear();
+        receiver.held_ = true;
+        receiver.onBatch_(receiver);
+    }
+
+    void erase(UringReceiver& receiver)
+    {
+        starved_.erase(std::remove(starved_.begin(), starved_.end(), &receiver), starved_.end());
+        receivers_.erase(std::find_if(receivers_.begin(), receivers_.end(),
+                                      [&receiver](const auto& owned) { return owned.get() == &receiver; }));
+    }
+
+    const unsigned         bufferCount_;
+    const std::size_t      bufferSize_;
+    const OnErrorCallBack& onError_;
+    int                    ringFd_       = -1;
+    int                    wakeFd_       = -1; /// eventfd, a read of it is always in flight
+    std::uint64_t          wakeValue_    = 0;  /// target of the eventfd read
+    bool                   deferTaskRun_ = false;
+
+    // the submission and completion rings, shared with the kernel
+    void*               ring_        = MAP_FAILED;
+    std::size_t         ringSize_    = 0;
+    io_uring_sqe*       sqes_        = static_cast<io_uring_sqe*>(MAP_FAILED);
+    std::size_t         sqesSize_    = 0;
+    const unsigned*     sqHead_      = nullptr;
+    unsigned*           sqTail_      = nullptr;
+    unsigned            sqMask_      = 0;
+    unsigned            sqEntries_   = 0;
+    unsigned            sqLocalTail_ = 0; /// next submission to fill
+    unsigned*           cqHead_      = nullptr;
+    const unsigned*     cqTail_      = nullptr;
+    unsigned            cqMask_      = 0;
+    const io_uring_cqe* cqes_        = nullptr;
+
+    // the provided buffers, shared with the kernel
+    io_uring_buf_ring*        bufferRing_     = static_cast<io_uring_buf_ring*>(MAP_FAILED);
+    std::size_t               bufferRingSize_ = 0;
+    std::uint16_t             bufferTail_     = 0; /// next entry of the buffer ring to fill
+    std::uint16_t             publishedTail_  = 0; /// tail the kernel knows
+    std::vector<std::uint8_t> buffers_        = {};
+
+    std::vector<std::unique_ptr<UringReceiver>> receivers_ = {};
+    std::vector<UringReceiver*>                 ready_     = {}; /// received something during the running poll()
+    std::vector<UringReceiver*>                 starved_   = {}; /// stopped for lack of buffers
+};
+
+} // namespace
+
+std::unique_ptr<IoEngine> adst::ep::test_engine::core::impl::makeIoUringEngine(int bufferCount, int bufferSize,
+                                                                               const OnErrorCallBack& onError,
+                                                                               std::string& reason)
+{
+    // the buffer ring needs a power of two
+    unsigned count = 1;
+    while (count < static_cast<unsigned>(bufferCount) && count < MAX_BUFFERS) {
+        count <<= 1U;
+    }
+    auto engine = std::make_unique<IoUringEngine>(count, static_cast<std::size_t>(bufferSize), onError);
+    if (!engine->setUp(reason)) {
+        return nullptr;
+    }
+    return engine;
+}
+
+#endif
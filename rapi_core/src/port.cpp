@@ -1,23 +1,56 @@
 
 #include "core/port.hpp"
 
-using Port = adst::ep::test_engine::core::Port;
+using OverloadPolicy = adst::ep::test_engine::core::OverloadPolicy;
+using Port           = adst::ep::test_engine::core::Port;
 
 Port::Port(Actor& actor, Network& network)
     : owner_(actor)
     , network_(network)
+    , limit_(actor.env_.portLimit_)
 {
     ADSTLOG_INIT_ACTOR_TRACE_MODULES(owner_.getName().c_str());
 }
 
+adst::ep::test_engine::core::CallBackHandle Port::newHandle()
+{
+    return owner_.newCallBackHandle();
+}
+
+std::shared_ptr<adst::ep::test_engine::core::impl::MessageCounters> Port::newCounters(const char* typeName)
+{
+    return owner_.env_.newMessageCounters(owner_.getName(), typeName);
+}
+
+bool Port::makeRoom(ChannelBase& channel, std::unique_lock<std::mutex>& eventLock)
+{
+    switch (limit_.policy_) {
+        case OverloadPolicy::DROP_NEWEST:
+            channel.countDrop();
+            return false;
+        case OverloadPolicy::BLOCK:
+            // the owner would wait for itself, its own events go beyond the capacity instead
+            if (!owner_.isRunningOnThisThread()) {
+                roomAvailable_.wait(eventLock, [this] { return !isFull() || limit_.policy_ != OverloadPolicy::BLOCK; });
+            }
+            return true;
+        case OverloadPolicy::DROP_OLDEST:
+        case OverloadPolicy::KEEP_LATEST: // no event of the type is queued
+        default:
+            // an urgent event is only dropped when there is nothing else
+            ChannelBase* oldest = dispatchOrder_.empty() ? urgentOrder_.take_front() : dispatchOrder_.take_front();
+            oldest->dropOldest();
+            return true;
+    }
+}
+
 std::size_t Port::processCommandsAndGetQueuedEventsCount()
 {
     std::unique_lock<std::mutex> eventCmdQueueLock{eventMutex_};
-    std::function<void()>        command;
+    CallBack                     command;
     while (!commandsQueue_.empty()) {
         // This can't add any extra commands, because in this queue we story only listen/unlisten commands.
-        command = commandsQueue_.front();
-        commandsQueue_.pop_front();
+        command = commandsQueue_.take_front();
         // If other thread starts schedule from network and there is a listen / unlisten executed from.
         // here on the same network then it would end in a deadlock if the network could not call schedule.
         eventCmdQueueLock.unlock();
@@ -25,29 +58,28 @@ std::size_t Port::processCommandsAndGetQueuedEventsCount()
         eventCmdQueueLock.lock();
     }
     // Yeah we want to return events count. So don't have to call getQueueEventCount
-    return eventQueue_.size();
+    return urgentOrder_.size() + dispatchOrder_.size();
 }
 
 int Port::consume(int max)
 {
     int consumed = 0;
-    LOG_C_D("Port::consume, commandsQueue.size=%d, eventQueue_.size=%d", commandsQueue_.size(), eventQueue_.size());
-    std::function<void()> eventCommand;
+    LOG_C_D("Port::consume, commandsQueue.size=%d, dispatchOrder_.size=%d", commandsQueue_.size(),
+            dispatchOrder_.size());
     while (processCommandsAndGetQueuedEventsCount() > 0 && consumed < max) // order is important
     {
-        {
-            std::lock_guard<std::mutex> guard{eventMutex_};
-            eventCommand = std::move(eventQueue_.front());
-            eventQueue_.pop_front();
-        }
-
-        eventCommand();
+        std::unique_lock<std::mutex> eventLock{eventMutex_};
+        ChannelBase* channel = urgentOrder_.empty() ? dispatchOrder_.take_front() : urgentOrder_.take_front();
+        channel->dispatchNext(eventLock); // unlocks before dispatching
         ++consumed;
+        if (owner_.chargeActivation()) {
+            break; // the port queues itself again behind the other work of the owner
+        }
     }
     {
         std::lock_guard<std::mutex> guard{eventMutex_};
         scheduled_ = false;
-        if (!eventQueue_.empty() || !commandsQueue_.empty()) {
+        if (!urgentOrder_.empty() || !dispatchOrder_.empty() || !commandsQueue_.empty()) {
             scheduleOnOwner();
         }
     }
@@ -59,6 +91,6 @@ void Port::scheduleOnOwner()
 {
     if (!scheduled_) {
         scheduled_ = true;
-        owner_.schedule([this] { consume(); });
+        owner_.schedule(consumeJob_);
     }
 }
@@ -1,6 +1,16 @@
 
+#include <cerrno>
+#include <cstring>
 #include <iostream>
 
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
 #include "adstutil_cxx/error_handler.hpp"
 
 #include <fmt/format.h>
@@ -10,24 +20,124 @@
 using Error           = adst::common::Error;
 using OnErrorCallBack = adst::common::OnErrorCallBack;
 
-using Priority = adst::ep::test_engine::core::Priority;
+using DispatcherSettings = adst::ep::test_engine::core::DispatcherSettings;
+using IoBackend          = adst::ep::test_engine::core::IoBackend;
+using Job                = adst::ep::test_engine::core::Job;
+using Priority           = adst::ep::test_engine::core::Priority;
+
+thread_local Priority::Dispatcher* Priority::currentDispatcher_ = nullptr;
+
+namespace {
 
-Priority::Priority(int dispatcherCount, const OnErrorCallBack& onErrorCallBack)
+constexpr int IO_POLL_INTERVAL = 32; /// jobs a busy dispatcher executes between two looks at its I/O engine
+
+} // namespace
+
+Priority::Priority(int dispatcherCount, const OnErrorCallBack& onErrorCallBack, DispatcherSettings settings)
     : onErrorCallBack_(onErrorCallBack)
+    , settings_(std::move(settings))
     , startCount_(dispatcherCount)
 {
     ADSTLOG_INIT_ACTOR_TRACE_MODULES("Priority");
+#if defined(__linux__)
+    for (const int cpu : settings_.cpus_) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            onErrorCallBack_(Error{{6, fmt::format("Priority: cpu {} of '{}' out of range", cpu, settings_.name_)}});
+        }
+    }
+#endif
+    // all dispatchers must exist before the first thread starts stealing from them.
     for (int count = 0; count < dispatcherCount; ++count) {
-        auto dispatcherName = fmt::format("dispatcher[{}]", count);
-        LOG_C_D("starting '%s'", dispatcherName.c_str());
-        dispatchers_.emplace_back([this, count] { dispatcherLoop(count); });
+        dispatchers_.emplace_back(std::make_unique<Dispatcher>(*this, count));
+        dispatchers_.back()->name_ = fmt::format("{}[{}]", settings_.name_, count);
+    }
+    for (auto& dispatcher : dispatchers_) {
+        LOG_C_D("starting '%s'", dispatcher->name_.c_str());
+        dispatcher->thread_ = std::thread([this, &dispatcher = *dispatcher] { dispatcherLoop(dispatcher); });
     }
 }
 
-void Priority::dispatcherLoop(int threadId)
+namespace {
+
+/**
+ * @param result Zero or the error number of a failed call.
+ * @return Empty on success otherwise the reason of the failure.
+ */
+std::string failure(int result)
+{
+    return (result == 0) ? std::string{} : fmt::format(" (failed: {})", std::strerror(result));
+}
+
+} // namespace
+
+void Priority::applySettings(Dispatcher& dispatcher)
 {
-    auto dispatcherName = fmt::format("dispatcher[{}]", threadId);
-    ADSTLOG_REGISTER_THREAD(0, dispatcherName.c_str());
+    std::string applied = fmt::format("'{}'", dispatcher.name_);
+#if defined(__linux__)
+    // the kernel limits thread names to 15 characters
+    pthread_setname_np(pthread_self(), dispatcher.name_.substr(0, 15).c_str());
+
+    if (!settings_.cpus_.empty()) {
+        cpu_set_t   cpuSet;
+        std::string cpus;
+        CPU_ZERO(&cpuSet);
+        for (size_t index = 0; index < settings_.cpus_.size(); ++index) {
+            if (settings_.pinEach_ && index != static_cast<size_t>(dispatcher.index_) % settings_.cpus_.size()) {
+                continue;
+            }
+            CPU_SET(settings_.cpus_[index], &cpuSet);
+            cpus += fmt::format("{}{}", cpus.empty() ? "" : ",", settings_.cpus_[index]);
+        }
+        const int result = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+        applied += fmt::format(" cpus={}{}", cpus, failure(result));
+    }
+
+    if (settings_.policy_ != DispatcherSettings::Policy::INHERIT) {
+        const bool  fifo  = settings_.policy_ == DispatcherSettings::Policy::FIFO;
+        sched_param param = {};
+        param.sched_priority = fifo ? settings_.priority_ : 0;
+        const int result     = pthread_setschedparam(pthread_self(), fifo ? SCHED_FIFO : SCHED_OTHER, &param);
+        applied += fifo ? fmt::format(" policy=SCHED_FIFO priority={}", settings_.priority_) : " policy=SCHED_OTHER";
+        applied += failure(result);
+    }
+
+    // nice is a per thread value on linux, it has no effect on real time threads.
+    if (settings_.policy_ != DispatcherSettings::Policy::FIFO && settings_.nice_ != 0) {
+        const int result =
+            setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), settings_.nice_) == 0 ? 0 : errno;
+        applied += fmt::format(" nice={}{}", settings_.nice_, failure(result));
+    }
+#else
+    if (!settings_.cpus_.empty() || settings_.policy_ != DispatcherSettings::Policy::INHERIT || settings_.nice_ != 0) {
+        applied += " (thread settings are not supported on this platform)";
+    }
+#endif
+    switch (settings_.idlePolicy_) {
+        case DispatcherSettings::IdlePolicy::SPIN:
+            applied += fmt::format(" idle=spin({},{})", settings_.spinCount_, settings_.yieldCount_);
+            break;
+        case DispatcherSettings::IdlePolicy::BUSY_SPIN:
+            applied += " idle=busySpin";
+            break;
+        default:
+            break;
+    }
+    if (settings_.ioBackend_ != IoBackend::NONE) {
+        // created by the dispatcher thread, io_uring binds the ring to the thread using it
+        std::string report;
+        dispatcher.ioEngine_ = impl::IoEngine::create(settings_.ioBackend_, settings_.ioBufferCount_,
+                                                      settings_.ioBufferSize_, onErrorCallBack_, report);
+        applied += report;
+    }
+    dispatcher.applied_ = applied;
+}
+
+void Priority::dispatcherLoop(Dispatcher& dispatcher)
+{
+    const int threadId = dispatcher.index_;
+    ADSTLOG_REGISTER_THREAD(0, dispatcher.name_.c_str());
+    applySettings(dispatcher);
+    currentDispatcher_ = &dispatcher;
     std::unique_lock<std::mutex> startLock(stateChangeMutex_);
     if (state_ != State::RUNNING) {
         startEvent_.wait(startLock, [this] { return state_ == State::RUNNING; });
@@ -39,41 +149,189 @@ void Priority::dispatcherLoop(int threadId)
     }
     startedEvent_.notify_one();
     LOG_C_D("dispatcher[%d] started", threadId);
-    std::unique_lock<std::mutex> actorQueueLock(stateChangeMutex_);
-    while (state_ == State::RUNNING || !actorQueue_.empty()) {
-        if (actorQueue_.empty()) {
-            // there could be 2 reason thread wakeup either there is an actor to be processed.
-            // or the priority level stopped
-            sleepingCount_++;
-            if (sleepingCount_ == dispatchers_.size()) {
-                idleEvent_.notify_one();
+    while (true) {
+        Job* job = takeJob(dispatcher);
+        if (job == nullptr) {
+            if (!idle(dispatcher)) {
+                break;
             }
-            scheduleEvent_.wait(actorQueueLock, [this] { return (!actorQueue_.empty() || state_ != State::RUNNING); });
-            sleepingCount_--;
+            continue;
+        }
+        // a busy dispatcher does not get to idle(), it looks at the sockets every now and then
+        if (dispatcher.ioEngine_ && ++dispatcher.jobsSinceIoPoll_ >= IO_POLL_INTERVAL) {
+            dispatcher.jobsSinceIoPoll_ = 0;
+            dispatcher.ioEngine_->poll(false);
         }
+        // now actually do the job.
+        LOG_C_T("scheduled callback on dispatcher[%d]", threadId);
+        Actor::thread_id = threadId;
+        // the job might be rescheduled (or its owner destroyed) by the time the callback returns.
+        const bool deleteAfterRun = job->deleteAfterRun_;
+        job->callBack_();
+        if (deleteAfterRun) {
+            delete job; // NOLINT(cppcoreguidelines-owning-memory)
+        }
+    }
+    // actors stop receiving when they are stopped, what is still registered is cancelled by the engine
+    dispatcher.ioEngine_.reset();
+    currentDispatcher_ = nullptr;
+}
 
-        // take an actor from the queue and start process it's queue
-        if (!actorQueue_.empty()) {
-            auto callBack = actorQueue_.front();
-            actorQueue_.pop_front();
-            // now actually do the job.
-            LOG_C_D("scheduled callback on dispatcher[%d]", threadId);
-            Actor::thread_id = threadId;
-            actorQueueLock.unlock();
-            callBack();
-            actorQueueLock.lock();
+Job* Priority::takeJob(Dispatcher& dispatcher)
+{
+    Job* job = nullptr;
+    if (dispatcher.pinnedCount_.load(std::memory_order_acquire) > 0) {
+        // nullptr while a producer is in the middle of a push, idle() sees the count and retries
+        job = dispatcher.pinnedQueue_.pop();
+        if (job != nullptr) {
+            dispatcher.pinnedCount_.fetch_sub(1);
+            pinnedCount_.fetch_sub(1);
+            return job;
         }
     }
+    if (queuedCount_.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+    if (dispatcher.localQueue_.steal(job)) {
+        queuedCount_.fetch_sub(1);
+        return job;
+    }
+    {
+        std::lock_guard<std::mutex> injectionGuard(injectionMutex_);
+        if (!injectionQueue_.empty()) {
+            job = injectionQueue_.front();
+            injectionQueue_.pop_front();
+            queuedCount_.fetch_sub(1);
+            return job;
+        }
+    }
+    // start with the neighbour so victims are spread among the thieves
+    const size_t count = dispatchers_.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        auto& victim = *dispatchers_[(static_cast<size_t>(dispatcher.index_) + offset) % count];
+        if (victim.localQueue_.steal(job)) {
+            queuedCount_.fetch_sub(1);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+bool Priority::idle(Dispatcher& dispatcher)
+{
+    auto* const ioEngine = dispatcher.ioEngine_.get();
+    if (ioEngine != nullptr && ioEngine->poll(false)) {
+        dispatcher.jobsSinceIoPoll_ = 0;
+        return true; // completions were handed to their actors, which might be queued now
+    }
+    std::unique_lock<std::mutex> stateLock(stateChangeMutex_);
+    if (hasJob(dispatcher)) {
+        return true; // a job was scheduled (or a steal failed on contention) retry
+    }
+    // there could be 2 reason thread wakeup either there is a job to be processed.
+    // or the priority level stopped
     sleepingCount_++;
-    startedEvent_.notify_one(); // unlock stop (reusing started event)
+    if (sleepingCount_ == dispatchers_.size()) {
+        idleEvent_.notify_all();
+        startedEvent_.notify_one(); // unlock stop (reusing started event)
+    }
+    if (state_ == State::STOPPED) {
+        return false; // stays counted as sleeping
+    }
+    if (settings_.idlePolicy_ != DispatcherSettings::IdlePolicy::PARK) {
+        spinningCount_++;
+        stateLock.unlock();
+        const bool woken = spin(dispatcher);
+        stateLock.lock();
+        if (woken) {
+            spinningCount_--;
+            sleepingCount_--;
+            return true;
+        }
+    }
+    // counted as parked before it stops counting as spinning, so schedule either sees one of them
+    // or this dispatcher sees the job in the wait predicate.
+    parkedCount_++;
+    dispatcher.parked_ = true;
+    if (settings_.idlePolicy_ != DispatcherSettings::IdlePolicy::PARK) {
+        spinningCount_--;
+    }
+    if (ioEngine != nullptr) {
+        // sleeps in the engine, so a completion wakes it as well as schedule(), which calls unpark()
+        if (!hasJob(dispatcher) && state_ != State::STOPPED) {
+            stateLock.unlock();
+            ioEngine->poll(true);
+            dispatcher.jobsSinceIoPoll_ = 0;
+            stateLock.lock();
+        }
+        if (dispatcher.parked_) {
+            dispatcher.parked_ = false;
+            parkedCount_--;
+        }
+    } else {
+        scheduleEvent_.wait(stateLock,
+                            [this, &dispatcher] { return (hasJob(dispatcher) || state_ == State::STOPPED); });
+        dispatcher.parked_ = false;
+        parkedCount_--;
+    }
+    sleepingCount_--;
+    return true;
 }
 
-void Priority::waitForIdle()
+void Priority::unpark(Dispatcher& dispatcher)
 {
-    std::unique_lock<std::mutex> actorQueueLock(stateChangeMutex_);
-    if (!actorQueue_.empty() || sleepingCount_ != dispatchers_.size()) {
-        idleEvent_.wait(actorQueueLock, [this] { return sleepingCount_ == dispatchers_.size(); });
+    dispatcher.parked_ = false;
+    parkedCount_--;
+    dispatcher.ioEngine_->wake();
+}
+
+namespace {
+
+/**
+ * Tells the cpu that the caller is in a spin loop, saves power and frees resources of the sibling
+ * hyper thread.
+ */
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+} // namespace
+
+bool Priority::spin(const Dispatcher& dispatcher)
+{
+    auto woken = [this, &dispatcher] { return hasJob(dispatcher) || state_ == State::STOPPED; };
+    if (settings_.idlePolicy_ == DispatcherSettings::IdlePolicy::BUSY_SPIN) {
+        while (!woken()) {
+            cpuRelax();
+        }
+        return true;
+    }
+    for (int count = 0; count < settings_.spinCount_; ++count) {
+        if (woken()) {
+            return true;
+        }
+        cpuRelax();
+    }
+    for (int count = 0; count < settings_.yieldCount_; ++count) {
+        if (woken()) {
+            return true;
+        }
+        std::this_thread::yield();
     }
+    return woken();
+}
+
+void Priority::waitForIdle()
+{
+    std::unique_lock<std::mutex> stateLock(stateChangeMutex_);
+    idleEvent_.wait(stateLock, [this] {
+        return queuedCount_ == 0 && pinnedCount_ == 0 && sleepingCount_ == dispatchers_.size();
+    });
 }
 
 Priority::~Priority()
@@ -101,9 +359,10 @@ Priority::~Priority()
                 break;
         }
     }
-    for (auto& thread : dispatchers_) {
-        thread.join();
-        ADSTLOG_UNREGISTER_THREAD(thread.native_handle());
+    for (auto& dispatcher : dispatchers_) {
+        auto nativeHandle = dispatcher->thread_.native_handle();
+        dispatcher->thread_.join();
+        ADSTLOG_UNREGISTER_THREAD(nativeHandle);
     }
 }
 
@@ -124,6 +383,9 @@ void Priority::start(std::unique_lock<std::mutex>& lock)
     startEvent_.notify_all();
     std::unique_lock<std::mutex> startLock(startedMutex_);
     startedEvent_.wait(startLock, [this] { return startCount_ == 0; });
+    for (const auto& dispatcher : dispatchers_) {
+        LOG_C_I("dispatcher %s", dispatcher->applied_.c_str());
+    }
 }
 
 void Priority::stop()
@@ -140,25 +402,78 @@ void Priority::stop(std::unique_lock<std::mutex>& lock)
     }
     state_ = State::STOPPING;
     LOG_C_D("running_ = STOPPING");
-    if (!actorQueue_.empty() || sleepingCount_ != dispatchers_.size()) {
-        LOG_C_D("waiting to finish: queue.size=%d, sleepingCount=%d", actorQueue_.size(), sleepingCount_);
-        startedEvent_.wait(lock, [this] { return (actorQueue_.empty() && sleepingCount_ == dispatchers_.size()); }); //
-        // started event reused.
+    if (queuedCount_ != 0 || pinnedCount_ != 0 || sleepingCount_ != dispatchers_.size()) {
+        LOG_C_D("waiting to finish: queued=%d, pinned=%d, sleepingCount=%d", static_cast<int>(queuedCount_.load()),
+                static_cast<int>(pinnedCount_.load()), static_cast<int>(sleepingCount_.load()));
+        startedEvent_.wait(lock, [this] {
+            return (queuedCount_ == 0 && pinnedCount_ == 0 && sleepingCount_ == dispatchers_.size());
+        }); // started event reused.
     }
     state_ = State::STOPPED;
     LOG_C_D("running_ = STOPPED");
+    for (auto& dispatcher : dispatchers_) {
+        if (dispatcher->ioEngine_) {
+            dispatcher->ioEngine_->wake();
+        }
+    }
     lock.unlock();
     scheduleEvent_.notify_all();
 }
 
 void Priority::schedule(CallBack callBack)
 {
-    std::lock_guard<std::mutex> actorQueueGuard(stateChangeMutex_);
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory) deleted by the dispatcher after execution
+    schedule(*new Job{std::move(callBack), true});
+}
+
+void Priority::schedule(Job& job)
+{
     if (state_ == State::STOPPED) {
         onErrorCallBack_(Error{{3, "Priority::schedule after STOPPED state reached"}});
     }
-    actorQueue_.push_back(std::move(callBack));
-    if (actorQueue_.size() == 1) {
-        scheduleEvent_.notify_all();
+    // counted before it becomes visible, so queuedCount_ never drops below 0
+    const auto queued = queuedCount_.fetch_add(1) + 1;
+    scheduledCount_.fetch_add(1, std::memory_order_relaxed);
+    if (currentDispatcher_ != nullptr && &currentDispatcher_->owner_ == this) {
+        currentDispatcher_->localQueue_.push(&job);
+    } else {
+        std::lock_guard<std::mutex> injectionGuard(injectionMutex_);
+        injectionQueue_.push_back(&job);
+    }
+    // one sleeper per job, and none as long as the spinning dispatchers can take all queued jobs
+    if (parkedCount_ > 0 && static_cast<size_t>(queued) > spinningCount_) {
+        std::lock_guard<std::mutex> stateGuard(stateChangeMutex_);
+        if (settings_.ioBackend_ == IoBackend::NONE) {
+            scheduleEvent_.notify_one();
+            return;
+        }
+        for (auto& parked : dispatchers_) {
+            if (parked->parked_) {
+                unpark(*parked);
+                break;
+            }
+        }
+    }
+}
+
+void Priority::schedule(Job& job, std::size_t dispatcher)
+{
+    if (state_ == State::STOPPED) {
+        onErrorCallBack_(Error{{3, "Priority::schedule after STOPPED state reached"}});
+    }
+    auto& target = *dispatchers_[dispatcher % dispatchers_.size()];
+    // counted before it becomes visible, so the counts never drop below 0
+    pinnedCount_.fetch_add(1);
+    target.pinnedCount_.fetch_add(1);
+    scheduledCount_.fetch_add(1, std::memory_order_relaxed);
+    target.pinnedQueue_.push(&job);
+    // only the target can take the job, the others wake up as well but go back to sleep
+    if (target.parked_) {
+        std::lock_guard<std::mutex> stateGuard(stateChangeMutex_);
+        if (settings_.ioBackend_ == IoBackend::NONE) {
+            scheduleEvent_.notify_all();
+        } else if (target.parked_) {
+            unpark(target);
+        }
     }
 }
@@ -0,0 +1,168 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "core/core.hpp"
+#include "gtest/gtest.h"
+
+#include "adstutil_cxx/compiler_diagnostics.hpp"
+#include "adstutil_cxx/error_handler.hpp"
+#include "adstutil_cxx/static_string.hpp"
+#include "test_helper/common_helper.hpp"
+
+using adst::ep::test_engine::core::StartCnf;
+
+namespace test_helper = adst::ep::test_engine::test_helper;
+namespace sstr        = ak_toolkit::static_str;
+
+namespace {
+
+std::atomic<bool>   countAllocations = {false}; /// set while the measured round trips are running
+std::atomic<size_t> allocationCount  = {0};     /// number of allocations while countAllocations is set
+
+} // namespace
+
+// counting replacement of the global allocation functions, all other forms forward to these
+void* operator new(std::size_t size)
+{
+    if (countAllocations.load(std::memory_order_relaxed)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    void* memory = std::malloc(size == 0 ? 1 : size); // NOLINT(cppcoreguidelines-no-malloc)
+    if (memory == nullptr) {
+        std::abort();
+    }
+    return memory;
+}
+
+// gcc does not know that operator new above uses malloc
+ADST_DISABLE_GCC_WARNING("mismatched-new-delete")
+void operator delete(void* memory) noexcept
+{
+    std::free(memory); // NOLINT(cppcoreguidelines-no-malloc)
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory); // NOLINT(cppcoreguidelines-no-malloc)
+}
+ADST_RESTORE_GCC_WARNING()
+
+static constexpr const int WARM_UP_COUNT  = 1000; /// round trips until queues reached their final size
+static constexpr const int MEASURED_COUNT = 10000;
+static constexpr const int RESERVED_COUNT = 256; /// more than the blocks the dispatchers can keep in their caches
+
+struct Ping final
+{
+    static constexpr auto NAME = sstr::literal("Ping");
+};
+
+struct Pong final
+{
+    static constexpr auto NAME = sstr::literal("Pong");
+};
+
+/**
+ * Answers each Ping with a Pong. Either the same Pong instance is published again or, when POOLED, a
+ * new one is created by make() for each answer.
+ */
+template <bool POOLED>
+struct Responder : public Actor
+{
+    // not copyable or movable
+    Responder(const Responder&) = delete;
+    Responder(Responder&&)      = delete;
+
+    Responder& operator=(const Responder&) = delete;
+    Responder& operator=(Responder&&) = delete;
+
+    explicit Responder(const Environment& env)
+        : Actor(NAME.c_str(), env)
+    {
+        listen<Ping>([this](const Ping&) {
+            if constexpr (POOLED) {
+                publish(make<Pong>());
+            } else {
+                // the same event instance is published for every round trip, so only the core allocates
+                getEnv().getNetworkForTest().publish(pong_);
+            }
+        });
+    }
+    ~Responder() override = default;
+
+    std::shared_ptr<Pong> pong_ = std::make_shared<Pong>();
+
+    static constexpr const auto NAME = sstr::literal("Responder");
+};
+
+template <bool POOLED>
+struct AllocationRoot : public Actor
+{
+    // not copyable or movable
+    AllocationRoot(const AllocationRoot&) = delete;
+    AllocationRoot(AllocationRoot&&)      = delete;
+
+    AllocationRoot& operator=(const AllocationRoot&) = delete;
+    AllocationRoot& operator=(AllocationRoot&&) = delete;
+
+    using SelfStartCnf = StartCnf<AllocationRoot>;
+
+    explicit AllocationRoot(const Environment& env)
+        : Actor(NAME.c_str(), env)
+    {
+        listen<SelfStartCnf>([this](const SelfStartCnf&) { sendPing(); });
+
+        listen<Pong>([this](const Pong&) {
+            ++roundTripCount;
+            if (roundTripCount == WARM_UP_COUNT) {
+                countAllocations = true;
+            }
+            if (roundTripCount == WARM_UP_COUNT + MEASURED_COUNT) {
+                countAllocations = false;
+                publish<Stop>(std::make_unique<Stop>());
+            } else {
+                sendPing();
+            }
+        });
+        newChild<Responder<POOLED>>();
+        if constexpr (POOLED) {
+            reserve<Ping>(RESERVED_COUNT); // Pong has the same size, they share the pool
+        }
+    }
+    ~AllocationRoot() override = default;
+
+    void sendPing()
+    {
+        if constexpr (POOLED) {
+            publish(make<Ping>());
+        } else {
+            getEnv().getNetworkForTest().publish(ping_);
+        }
+    }
+
+    std::shared_ptr<Ping> ping_ = std::make_shared<Ping>();
+
+    static int roundTripCount;
+
+    static constexpr const auto NAME = sstr::literal("AllocationRoot");
+};
+
+template <bool POOLED>
+int AllocationRoot<POOLED>::roundTripCount = 0;
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, PublishDispatchDoesNotAllocate)
+{
+    allocationCount = 0;
+    test_helper::runCoreDefault<AllocationRoot<false>>();
+    EXPECT_EQ(AllocationRoot<false>::roundTripCount, WARM_UP_COUNT + MEASURED_COUNT);
+    EXPECT_EQ(allocationCount.load(), 0U);
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, PooledMessagesDoNotAllocate)
+{
+    allocationCount = 0;
+    test_helper::runCoreDefault<AllocationRoot<true>>();
+    EXPECT_EQ(AllocationRoot<true>::roundTripCount, WARM_UP_COUNT + MEASURED_COUNT);
+    EXPECT_EQ(allocationCount.load(), 0U);
+}
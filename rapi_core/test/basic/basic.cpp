@@ -1,4 +1,5 @@
 #include <istream>
+#include <thread>
 #include "core/core.hpp"
 #include "gtest/gtest.h"
 
@@ -9,6 +10,7 @@
 
 using adst::common::ConfigAndLogger;
 using adst::common::Error;
+using adst::ep::test_engine::core::PriorityLevel;
 using adst::ep::test_engine::core::StartCnf;
 
 namespace test_helper = adst::ep::test_engine::test_helper;
@@ -326,3 +328,219 @@ TEST(EPTestEngineCoreTest, StandaloneActor)
     Environment     env(confLog);
     StandaloneActor act(env);
 }
+
+static constexpr const int MIXED_MESSAGE_COUNT = 1000;
+
+template <int number>
+struct Ordered final
+{
+    explicit Ordered(int sequence)
+        : sequence_(sequence)
+    {
+    }
+
+    int                         sequence_ = 0;
+    static constexpr const auto NAME      = sstr::literal("Ordered") + test_helper::NumToChar<number>::VALUE;
+};
+
+struct OrderedReceiver : public Actor
+{
+    // not copyable or movable
+    OrderedReceiver(const OrderedReceiver&) = delete;
+    OrderedReceiver(OrderedReceiver&&)      = delete;
+
+    OrderedReceiver& operator=(const OrderedReceiver&) = delete;
+    OrderedReceiver& operator=(OrderedReceiver&&) = delete;
+
+    explicit OrderedReceiver(const Environment& env)
+        : Actor(NAME.c_str(), env)
+    {
+        listen<Ordered<0>>([this](const Ordered<0>& msg) { received(msg.sequence_); });
+        listen<Ordered<1>>([this](const Ordered<1>& msg) { received(msg.sequence_); });
+        listen<Ordered<2>>([this](const Ordered<2>& msg) { received(msg.sequence_); });
+    }
+    ~OrderedReceiver() override = default;
+
+    void received(int sequence)
+    {
+        EXPECT_EQ(sequence, expected_);
+        expected_ = sequence + 1;
+        if (expected_ == MIXED_MESSAGE_COUNT) {
+            publish<Stop>(std::make_unique<Stop>());
+        }
+    }
+
+    int expected_ = 0;
+
+    static constexpr const auto NAME = sstr::literal("OrderedReceiver");
+};
+
+struct BudgetedReceiver : public OrderedReceiver
+{
+    // not copyable or movable
+    BudgetedReceiver(const BudgetedReceiver&) = delete;
+    BudgetedReceiver(BudgetedReceiver&&)      = delete;
+
+    BudgetedReceiver& operator=(const BudgetedReceiver&) = delete;
+    BudgetedReceiver& operator=(BudgetedReceiver&&) = delete;
+
+    explicit BudgetedReceiver(const Environment& env)
+        : OrderedReceiver(env)
+    {
+        // every message goes through the priority again
+        setActivationBudget(1);
+    }
+    ~BudgetedReceiver() override = default;
+
+    static constexpr const auto NAME = sstr::literal("BudgetedReceiver");
+};
+
+template <typename Receiver>
+struct MixedTypesRoot : public Actor
+{
+    // not copyable or movable
+    MixedTypesRoot(const MixedTypesRoot&) = delete;
+    MixedTypesRoot(MixedTypesRoot&&)      = delete;
+
+    MixedTypesRoot& operator=(const MixedTypesRoot&) = delete;
+    MixedTypesRoot& operator=(MixedTypesRoot&&) = delete;
+
+    using SelfStartCnf = StartCnf<MixedTypesRoot>;
+
+    explicit MixedTypesRoot(const Environment& env)
+        : Actor(NAME.c_str(), env)
+    {
+        // the event types are queued separately in the port of the receiver, the order must survive
+        listen<SelfStartCnf>([this](const SelfStartCnf&) {
+            for (int sequence = 0; sequence < MIXED_MESSAGE_COUNT; ++sequence) {
+                switch (sequence % 3) {
+                    case 0:
+                        publish(std::make_unique<Ordered<0>>(sequence));
+                        break;
+                    case 1:
+                        publish(std::make_unique<Ordered<1>>(sequence));
+                        break;
+                    default:
+                        publish(std::make_unique<Ordered<2>>(sequence));
+                        break;
+                }
+            }
+        });
+        newChild<Receiver>();
+    }
+    ~MixedTypesRoot() override = default;
+
+    static constexpr const auto NAME = sstr::literal("MixedTypesRoot");
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, MixedTypesKeepOrder)
+{
+    test_helper::runCoreDefault<MixedTypesRoot<OrderedReceiver>>();
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, ActivationBudgetKeepsOrder)
+{
+    test_helper::runCoreDefault<MixedTypesRoot<BudgetedReceiver>>();
+}
+
+struct WhereAreYou final
+{
+    static constexpr const auto NAME = sstr::literal("WhereAreYou");
+};
+
+struct HereIAm final
+{
+    HereIAm(PriorityLevel level, std::thread::id threadId)
+        : level_(level)
+        , threadId_(threadId)
+    {
+    }
+
+    PriorityLevel               level_;    /// level of the replying actor
+    std::thread::id             threadId_; /// dispatcher thread of the replying actor
+    static constexpr const auto NAME = sstr::literal("HereIAm");
+};
+
+template <int number>
+struct LevelReporter : public Actor
+{
+    // not copyable or movable
+    LevelReporter(const LevelReporter&) = delete;
+    LevelReporter(LevelReporter&&)      = delete;
+
+    LevelReporter& operator=(const LevelReporter&) = delete;
+    LevelReporter& operator=(LevelReporter&&) = delete;
+
+    explicit LevelReporter(const Environment& env)
+        : Actor(NAME.c_str(), env)
+    {
+        listen<WhereAreYou>([this](const WhereAreYou&) {
+            publish(std::make_unique<HereIAm>(getPriorityLevel(), std::this_thread::get_id()));
+        });
+    }
+    ~LevelReporter() override = default;
+
+    static constexpr const auto NAME = sstr::literal("LevelReporter") + test_helper::NumToChar<number>::VALUE;
+};
+
+struct LevelsRoot : public Actor
+{
+    // not copyable or movable
+    LevelsRoot(const LevelsRoot&) = delete;
+    LevelsRoot(LevelsRoot&&)      = delete;
+
+    LevelsRoot& operator=(const LevelsRoot&) = delete;
+    LevelsRoot& operator=(LevelsRoot&&) = delete;
+
+    using SelfStartCnf = StartCnf<LevelsRoot>;
+
+    explicit LevelsRoot(const Environment& env)
+        : Actor(NAME.c_str(), env)
+    {
+        listen<SelfStartCnf>([this](const SelfStartCnf&) {
+            rootThreadId_ = std::this_thread::get_id();
+            publish(std::make_unique<WhereAreYou>());
+        });
+        listen<HereIAm>([this](const HereIAm& msg) {
+            threadIds_[static_cast<size_t>(msg.level_)] = msg.threadId_;
+            if (++replyCount_ == 2) {
+                publish<Stop>(std::make_unique<Stop>());
+            }
+        });
+        newChild<LevelReporter<0>>(PriorityLevel::HIGH);
+        newChild<LevelReporter<1>>(); // inherits NORMAL
+    }
+    ~LevelsRoot() override = default;
+
+    int                         replyCount_ = 0;
+    static std::thread::id      rootThreadId_;
+    static std::thread::id      threadIds_[adst::ep::test_engine::core::PRIORITY_LEVEL_COUNT];
+    static constexpr const auto NAME = sstr::literal("LevelsRoot");
+};
+
+std::thread::id LevelsRoot::rootThreadId_;
+std::thread::id LevelsRoot::threadIds_[adst::ep::test_engine::core::PRIORITY_LEVEL_COUNT];
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, PriorityLevelsUseOwnDispatchers)
+{
+    using adst::common::Config;
+    auto onError = [](const Error& error) {
+        std::cout << error.errorCodeName_.second << std::endl;
+        GTEST_FAIL();
+    };
+    // a single normal dispatcher and a single high priority dispatcher
+    ConfigAndLogger confLog = {Config{onError, 1, Config::CONFIG_FILE_NAME.c_str(), Config::DEFAULT_CONFIG.c_str(),
+                                      Config::DEFAULT_MAX_MESSAGES_PER_ACTIVATION, std::chrono::microseconds{0}, 1}};
+    Core            core(confLog);
+    core.init<LevelsRoot>();
+    core.run();
+
+    const auto highThreadId   = LevelsRoot::threadIds_[static_cast<size_t>(PriorityLevel::HIGH)];
+    const auto normalThreadId = LevelsRoot::threadIds_[static_cast<size_t>(PriorityLevel::NORMAL)];
+    EXPECT_NE(highThreadId, std::thread::id());
+    EXPECT_EQ(normalThreadId, LevelsRoot::rootThreadId_);
+    EXPECT_NE(highThreadId, normalThreadId);
+}
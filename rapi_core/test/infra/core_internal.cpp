@@ -1,7 +1,19 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <istream>
+#include <sstream>
+#include <thread>
 
 #include "adstutil_cxx/error_handler.hpp"
 
+#include "core/core.hpp"
 #include "core/priority.hpp"
 #include "gtest/gtest.h"
 #include "test_helper/simple_actors.hpp"
@@ -10,7 +22,15 @@ using adst::common::Config;
 using adst::common::ConfigAndLogger;
 using adst::common::Error;
 using adst::ep::test_engine::core::Actor;
+using adst::ep::test_engine::core::ConflationKey;
+using adst::ep::test_engine::core::Core;
+using adst::ep::test_engine::core::DispatcherSettings;
 using adst::ep::test_engine::core::Environment;
+using adst::ep::test_engine::core::IoDatagrams;
+using adst::ep::test_engine::core::Network;
+using adst::ep::test_engine::core::OverloadPolicy;
+using adst::ep::test_engine::core::PortLimit;
+using adst::ep::test_engine::core::impl::FlowTrace;
 
 static constexpr int EXPECTED_ERROR_CODE = 42;
 
@@ -124,6 +144,89 @@ TEST(EPTestEngineCoreTest, PriorityTowStart)
     EXPECT_EXIT(prio.start();, ::testing::ExitedWithCode(EXPECTED_ERROR_CODE), "");
 }
 
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, PriorityDispatcherSettings)
+{
+    const std::string doc =
+        "---\n"
+        "dispatchers:\n"
+        "  normal:\n"
+        "    cpus: 0\n"
+        "    policy: SCHED_OTHER\n";
+    ConfigAndLogger confLog = {Config{onError, 2, "", doc}};
+    auto            env     = Environment(confLog);
+    auto&           prio    = env.getPrioForTest();
+
+    std::string threadName;
+    int         cpu = -1;
+    prio.start();
+    prio.schedule([&threadName, &cpu] {
+        char name[16] = {};
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        threadName = name;
+        cpu        = sched_getcpu();
+    });
+    prio.waitForIdle();
+    prio.stop();
+
+    EXPECT_EQ(threadName.rfind("normal[", 0), 0U);
+    EXPECT_EQ(cpu, 0);
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, PriorityIdlePolicies)
+{
+    using adst::ep::test_engine::core::Priority;
+    ConfigAndLogger confLog = {Config{onError, DISPATCHER_COUNT}};
+    for (auto idlePolicy : {DispatcherSettings::IdlePolicy::PARK, DispatcherSettings::IdlePolicy::SPIN,
+                            DispatcherSettings::IdlePolicy::BUSY_SPIN}) {
+        DispatcherSettings settings;
+        settings.idlePolicy_ = idlePolicy;
+        Priority         prio(2, onError, settings);
+        std::atomic<int> count = {0};
+        prio.start();
+        for (int round = 0; round < 10; ++round) {
+            for (int job = 0; job < 10; ++job) {
+                prio.schedule([&count] { count++; });
+            }
+            prio.waitForIdle();
+            EXPECT_EQ(count, (round + 1) * 10);
+        }
+        prio.stop();
+    }
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, PriorityPinnedJobs)
+{
+    using adst::ep::test_engine::core::Job;
+    using adst::ep::test_engine::core::Priority;
+    for (auto idlePolicy : {DispatcherSettings::IdlePolicy::PARK, DispatcherSettings::IdlePolicy::SPIN}) {
+        DispatcherSettings settings;
+        settings.idlePolicy_ = idlePolicy;
+        Priority                     prio(4, onError, settings);
+        std::mutex                   threadsMutex;
+        std::vector<std::thread::id> threads;
+        std::vector<std::unique_ptr<Job>> jobs;
+        for (int job = 0; job < 100; ++job) {
+            jobs.emplace_back(std::make_unique<Job>([&threadsMutex, &threads] {
+                std::lock_guard<std::mutex> guard{threadsMutex};
+                threads.push_back(std::this_thread::get_id());
+            }));
+        }
+        prio.start();
+        for (auto& job : jobs) {
+            prio.schedule(*job, 6); // modulo the dispatcher count, the third one
+            std::this_thread::yield();
+        }
+        prio.waitForIdle();
+        prio.stop();
+
+        ASSERT_EQ(threads.size(), jobs.size());
+        EXPECT_TRUE(std::all_of(threads.begin(), threads.end(), [&threads](auto id) { return id == threads[0]; }));
+    }
+}
+
 struct PortTestRoot : public Actor
 {
     // not copiable or movable
@@ -136,6 +239,7 @@ struct PortTestRoot : public Actor
         : Actor(NAME.c_str(), *env)
         , envPrt_(env)
     {
+        setActivationBudget(0); // the ports are consumed by hand, outside of an activation
     }
 
     ~PortTestRoot() override
@@ -283,3 +387,430 @@ TEST(EPTestEngineCoreTest, ScheduleNetworkNoListen)
     PortTestRoot root(env);
     env->getNetworkForTest().publish(std::make_unique<StartReq<PortTestRoot>>());
 }
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, NetworkListenUnlisten)
+{
+    using StartReq          = StartReq<PortTestRoot>;
+    ConfigAndLogger confLog = {Config{onError, DISPATCHER_COUNT}};
+    Network         network;
+    int             firstCount  = 0;
+    int             secondCount = 0;
+
+    auto handle = network.listen<StartReq>([&firstCount](const std::shared_ptr<StartReq>) { ++firstCount; });
+    network.listen<StartReq>([&secondCount](const std::shared_ptr<StartReq>) { ++secondCount; });
+    network.publish(std::make_unique<StartReq>());
+    network.unlisten<StartReq>(handle);
+    network.publish(std::make_unique<StartReq>());
+    network.unlisten<Stop>(handle);
+
+    EXPECT_EQ(firstCount, 1);
+    EXPECT_EQ(secondCount, 2);
+}
+
+struct Bulk
+{
+    static constexpr auto NAME = sstr::literal("Bulk");
+};
+
+// clang-format off
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory, google-readability-function-size, readability-function-size)
+TEST(EPTestEngineCoreTest, ScheduleUrgentFirst)
+// clang-format on
+{
+    using StartReq          = StartReq<PortTestRoot>;
+    ConfigAndLogger confLog = {Config{onError, DISPATCHER_COUNT}};
+    // the root deletes the environment, the events are consumed by hand.
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    auto*            env = new Environment(confLog);
+    PortTestRoot     root(env);
+    auto&            port = root.getPortForTest(0);
+    std::vector<int> order;
+    port.listen<Bulk>([&order](const Bulk&) { order.push_back(0); });
+    port.listen<StartReq>([&order](const StartReq&) { order.push_back(1); });
+    port.schedule(std::make_unique<Bulk>());
+    port.schedule(std::make_unique<Bulk>());
+    port.schedule(std::make_unique<StartReq>());
+    port.consume();
+
+    EXPECT_EQ(order, (std::vector<int>{1, 0, 0}));
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, FlowTraceDumpAndDecode)
+{
+    ConfigAndLogger confLog = {Config{onError, DISPATCHER_COUNT}};
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    auto*        env = new Environment(confLog);
+    PortTestRoot root(env);
+    auto&        port = root.getPortForTest(0);
+    port.listen<Bulk>([](const Bulk&) {});
+    FlowTrace::enable(4);
+    port.schedule(std::make_unique<Bulk>());
+    port.consume();
+    FlowTrace::disable();
+
+    std::stringstream dump;
+    FlowTrace::dump(dump);
+    std::stringstream text;
+    ASSERT_TRUE(FlowTrace::decodeText(dump, text));
+    const auto lines = text.str();
+    EXPECT_NE(lines.find("QUEUE          PortTestRoot Bulk"), std::string::npos);
+    EXPECT_NE(lines.find("DISPATCH_BEGIN PortTestRoot Bulk"), std::string::npos);
+    EXPECT_NE(lines.find("DISPATCH_END   PortTestRoot Bulk"), std::string::npos);
+
+    dump.clear();
+    dump.seekg(0);
+    std::stringstream json;
+    ASSERT_TRUE(FlowTrace::decodeChromeTrace(dump, json));
+    EXPECT_NE(json.str().find(R"("name":"Bulk","cat":"flow","ph":"B")"), std::string::npos);
+
+    std::stringstream garbage("not a dump");
+    EXPECT_FALSE(FlowTrace::decodeText(garbage, text));
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, PortMetrics)
+{
+    const std::string doc =
+        "---\n"
+        "metrics:\n"
+        "  enabled: true\n";
+    ConfigAndLogger confLog = {Config{onError, DISPATCHER_COUNT, "", doc}};
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    auto*        env = new Environment(confLog);
+    PortTestRoot root(env);
+    auto&        port = root.getPortForTest(0);
+    port.listen<Bulk>([](const Bulk&) { std::this_thread::sleep_for(std::chrono::milliseconds{1}); });
+    port.schedule(std::make_unique<Bulk>());
+    port.schedule(std::make_unique<Bulk>());
+    port.schedule(std::make_unique<Bulk>());
+    port.consume();
+
+    const auto metrics = env->collectMetrics();
+    const auto bulk    = std::find_if(metrics.begin(), metrics.end(), [](const auto& entry) {
+        return entry.actor_ == "PortTestRoot" && entry.type_ == "Bulk";
+    });
+    ASSERT_NE(bulk, metrics.end());
+    EXPECT_EQ(bulk->queued_, 3U);
+    EXPECT_EQ(bulk->dispatched_, 3U);
+    EXPECT_EQ(bulk->maxQueueDepth_, 3U);
+    EXPECT_EQ(bulk->service_.count_, 3U);
+    EXPECT_GE(bulk->service_.percentile(0.5), 1000000U);
+    EXPECT_GE(bulk->latency_.max_, 1000000U); // the last one waited for the first two
+}
+
+struct Sample
+{
+    explicit Sample(int value = 0)
+        : value_(value)
+    {
+    }
+    int value_;
+
+    static constexpr auto NAME = sstr::literal("Sample");
+};
+
+struct OverloadTestRoot : public PortTestRoot
+{
+    using PortTestRoot::PortTestRoot;
+
+    PortIndex attachPortForTest()
+    {
+        return attachPort(Environment::DEFAULT_NETWORK);
+    }
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, PortOverloadPolicies)
+{
+    const std::string doc =
+        "---\n"
+        "metrics:\n"
+        "  enabled: true\n"
+        "ports:\n"
+        "  capacity: 2\n";
+    ConfigAndLogger confLog = {Config{onError, DISPATCHER_COUNT, "", doc}};
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    auto*            env = new Environment(confLog);
+    OverloadTestRoot root(env);
+    std::vector<int> received;
+
+    // each policy gets a fresh port, a port consumed by hand can only be consumed once
+    auto run = [&root, &received](OverloadPolicy policy, const std::vector<int>& values) {
+        auto& port = root.getPortForTest(root.attachPortForTest());
+        port.setLimit(PortLimit{2, policy});
+        port.listen<Sample>([&received](const Sample& sample) { received.push_back(sample.value_); });
+        port.listen<Bulk>([&received](const Bulk&) { received.push_back(0); });
+        received.clear();
+        for (const auto value : values) {
+            if (value == 0) {
+                port.schedule(std::make_unique<Bulk>());
+            } else {
+                port.schedule(std::make_unique<Sample>(value));
+            }
+        }
+        port.consume();
+        return received;
+    };
+    EXPECT_EQ(run(OverloadPolicy::DROP_OLDEST, {1, 2, 3}), (std::vector<int>{2, 3}));
+    EXPECT_EQ(run(OverloadPolicy::DROP_NEWEST, {1, 2, 3}), (std::vector<int>{1, 2}));
+    EXPECT_EQ(run(OverloadPolicy::KEEP_LATEST, {1, 2, 3}), (std::vector<int>{1, 3}));
+    EXPECT_EQ(run(OverloadPolicy::KEEP_LATEST, {0, 0, 1}), (std::vector<int>{0, 1}));
+
+    std::uint64_t droppedSamples    = 0;
+    std::uint64_t dispatchedSamples = 0;
+    std::uint64_t droppedBulks      = 0;
+    for (const auto& entry : env->collectMetrics()) {
+        if (entry.type_ == "Sample") {
+            droppedSamples += entry.dropped_;
+            dispatchedSamples += entry.dispatched_;
+        } else if (entry.type_ == "Bulk") {
+            droppedBulks += entry.dropped_;
+        }
+    }
+    EXPECT_EQ(droppedSamples, 3U);
+    EXPECT_EQ(dispatchedSamples, 7U);
+    EXPECT_EQ(droppedBulks, 1U);
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, PortListenLatest)
+{
+    const std::string doc =
+        "---\n"
+        "metrics:\n"
+        "  enabled: true\n";
+    ConfigAndLogger confLog = {Config{onError, DISPATCHER_COUNT, "", doc}};
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    auto*            env = new Environment(confLog);
+    OverloadTestRoot root(env);
+    std::vector<int> received;
+
+    // each case gets a fresh port, a port consumed by hand can only be consumed once
+    auto run = [&root, &received](std::function<ConflationKey(const Sample&)> keyOf, int count) {
+        auto& port = root.getPortForTest(root.attachPortForTest());
+        port.listenLatest<Sample>([&received](const Sample& sample) { received.push_back(sample.value_); },
+                                  std::move(keyOf));
+        received.clear();
+        for (int value = 1; value <= count; ++value) {
+            port.schedule(std::make_unique<Sample>(value));
+        }
+        port.consume();
+        return received;
+    };
+    EXPECT_EQ(run(nullptr, 3), (std::vector<int>{3}));
+    // odd and even values have their own slot
+    EXPECT_EQ(run([](const Sample& sample) { return static_cast<ConflationKey>(sample.value_ % 2); }, 5),
+              (std::vector<int>{5, 4}));
+
+    std::uint64_t conflated = 0;
+    for (const auto& entry : env->collectMetrics()) {
+        conflated += entry.conflated_;
+    }
+    EXPECT_EQ(conflated, 5U);
+}
+
+struct NetworkTestRoot : public PortTestRoot
+{
+    explicit NetworkTestRoot(const Environment* env)
+        : PortTestRoot(env)
+        , dataPort_(attachPort("data"))
+    {
+    }
+
+    const PortIndex dataPort_;
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, NetworksAreIsolated)
+{
+    ConfigAndLogger confLog = {Config{onError, DISPATCHER_COUNT}};
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    auto*           env = new Environment(confLog);
+    NetworkTestRoot root(env);
+    auto&           controlPort  = root.getPortForTest(0);
+    auto&           dataPort     = root.getPortForTest(root.dataPort_);
+    int             controlCount = 0;
+    int             dataCount    = 0;
+    const auto controlHandle = controlPort.listen<Bulk>([&controlCount](const Bulk&) { ++controlCount; });
+    const auto dataHandle    = dataPort.listen<Bulk>([&dataCount](const Bulk&) { ++dataCount; });
+    EXPECT_NE(controlHandle, dataHandle);
+
+    EXPECT_EQ(&env->getNetworkForTest("data"), &dataPort.getNetwork());
+    EXPECT_NE(&env->getNetworkForTest(), &dataPort.getNetwork());
+    env->getNetworkForTest().publish(std::make_unique<Bulk>());
+    env->getNetworkForTest("data").publish(std::make_unique<Bulk>());
+    env->getNetworkForTest("data").publish(std::make_unique<Bulk>());
+    controlPort.consume();
+    dataPort.consume();
+
+    EXPECT_EQ(controlCount, 1);
+    EXPECT_EQ(dataCount, 2);
+}
+
+struct Control
+{
+    static constexpr auto NAME = sstr::literal("Control");
+};
+
+/**
+ * Records the order it gets the messages of its two ports in, the data port dispatches one message
+ * per turn.
+ */
+struct PortBudgetChild : public Actor
+{
+    // not copiable or movable
+    PortBudgetChild(const PortBudgetChild&) = delete;
+    PortBudgetChild& operator=(const PortBudgetChild&) = delete;
+    PortBudgetChild(PortBudgetChild&&)                 = delete;
+    PortBudgetChild& operator=(PortBudgetChild&&) = delete;
+
+    PortBudgetChild(const Environment& env, std::vector<int>& order)
+        : Actor(NAME.c_str(), env)
+    {
+        const auto dataPort = attachPort("data", 1);
+        listenOn<Bulk>(dataPort, [this, &order](const Bulk&) { received(order, 0); });
+        listen<Control>([this, &order](const Control&) { received(order, 1); });
+    }
+    ~PortBudgetChild() override = default;
+
+    void received(std::vector<int>& order, int message)
+    {
+        order.push_back(message);
+        if (order.size() == 4) {
+            publish(std::make_unique<Stop>());
+        }
+    }
+
+    static constexpr const auto NAME = sstr::literal("PortBudgetChild");
+};
+
+/**
+ * Floods the data port of the child, then sends a control message.
+ */
+struct PortBudgetRoot : public Actor
+{
+    // not copiable or movable
+    PortBudgetRoot(const PortBudgetRoot&) = delete;
+    PortBudgetRoot& operator=(const PortBudgetRoot&) = delete;
+    PortBudgetRoot(PortBudgetRoot&&)                 = delete;
+    PortBudgetRoot& operator=(PortBudgetRoot&&) = delete;
+
+    using SelfStartCnf = StartCnf<PortBudgetRoot>;
+
+    PortBudgetRoot(const Environment& env, std::vector<int>& order)
+        : Actor(NAME.c_str(), env)
+    {
+        const auto dataPort = attachPort("data");
+        listen<SelfStartCnf>([this, dataPort](const SelfStartCnf&) {
+            publishOn(dataPort, std::make_unique<Bulk>());
+            publishOn(dataPort, std::make_unique<Bulk>());
+            publishOn(dataPort, std::make_unique<Bulk>());
+            publish(std::make_unique<Control>());
+        });
+        newChild<PortBudgetChild>(order);
+    }
+    ~PortBudgetRoot() override = default;
+
+    static constexpr const auto NAME = sstr::literal("PortBudgetRoot");
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, PortDrainBudget)
+{
+    // a single dispatcher, so the root publishes everything before the child runs
+    ConfigAndLogger  confLog = {Config{onError, 1}};
+    std::vector<int> order;
+    {
+        Core core(confLog);
+        core.init<PortBudgetRoot>(order);
+        core.run();
+    }
+
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 0, 0}));
+}
+
+/**
+ * Receives datagrams through the I/O engine of its dispatcher and stops the core when all arrived.
+ */
+struct IoReceiveActor : public Actor
+{
+    // not copiable or movable
+    IoReceiveActor(const IoReceiveActor&) = delete;
+    IoReceiveActor& operator=(const IoReceiveActor&) = delete;
+    IoReceiveActor(IoReceiveActor&&)                 = delete;
+    IoReceiveActor& operator=(IoReceiveActor&&) = delete;
+
+    using SelfStartCnf = StartCnf<IoReceiveActor>;
+
+    IoReceiveActor(const Environment& env, int fd, std::size_t expected, std::vector<std::uint32_t>& received,
+                   std::uint16_t& peerPort)
+        : Actor(NAME.c_str(), env)
+    {
+        pinToDispatcher(1);
+        listen<SelfStartCnf>([this, fd, expected, &received, &peerPort](const SelfStartCnf&) {
+            receive(fd, [this, expected, &received, &peerPort](const IoDatagrams& datagrams) {
+                for (const auto& datagram : datagrams) {
+                    std::uint32_t index = 0;
+                    ASSERT_EQ(datagram.size_, sizeof(index)); // NOLINT
+                    std::memcpy(&index, datagram.data_, sizeof(index));
+                    received.push_back(index);
+                    peerPort = datagram.peerPort_;
+                }
+                if (received.size() == expected) {
+                    publish(std::make_unique<Stop>());
+                }
+            });
+        });
+    }
+    ~IoReceiveActor() override = default;
+
+    static constexpr const auto NAME = sstr::literal("IoReceiveActor");
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(EPTestEngineCoreTest, ActorReceiveIoEngine)
+{
+    // few enough to fit into the default socket buffer, they are sent before the core runs
+    constexpr std::uint32_t DATAGRAM_COUNT = 100;
+    for (const std::string backend : {"epoll", "uring"}) {
+        const int   receiver = ::socket(AF_INET, SOCK_DGRAM, 0);
+        const int   sender   = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in address  = {};
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(receiver, reinterpret_cast<const sockaddr*>(&address), sizeof(address)); // NOLINT
+        ::bind(sender, reinterpret_cast<const sockaddr*>(&address), sizeof(address));   // NOLINT
+        socklen_t length = sizeof(address);
+        ::getsockname(receiver, reinterpret_cast<sockaddr*>(&address), &length); // NOLINT
+        for (std::uint32_t index = 0; index < DATAGRAM_COUNT; ++index) {
+            ::sendto(sender, &index, sizeof(index), 0, reinterpret_cast<const sockaddr*>(&address), // NOLINT
+                     sizeof(address));
+        }
+        ::getsockname(sender, reinterpret_cast<sockaddr*>(&address), &length); // NOLINT
+
+        const std::string doc =
+            "---\n"
+            "dispatchers:\n"
+            "  normal:\n"
+            "    io: " +
+            backend + "\n    ioBuffers: 16\n";
+        ConfigAndLogger            confLog = {Config{onError, 2, "", doc}};
+        std::vector<std::uint32_t> received;
+        std::uint16_t              peerPort = 0;
+        {
+            Core core(confLog);
+            core.init<IoReceiveActor>(receiver, DATAGRAM_COUNT, received, peerPort);
+            core.run();
+        }
+        ::close(sender);
+        ::close(receiver);
+
+        ASSERT_EQ(received.size(), DATAGRAM_COUNT) << backend; // NOLINT
+        for (std::uint32_t index = 0; index < DATAGRAM_COUNT; ++index) {
+            EXPECT_EQ(received[index], index) << backend;
+        }
+        EXPECT_EQ(peerPort, ntohs(address.sin_port)) << backend;
+    }
+}
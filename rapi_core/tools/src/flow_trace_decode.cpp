@@ -0,0 +1,46 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "core/impl/flow_trace.hpp"
+
+using adst::ep::test_engine::core::impl::FlowTrace;
+
+/**
+ * Decodes a flow trace dump (see flowTrace/file in the config) offline:
+ *
+ *     RapiFlowTraceDecode [--chrome] <dump> [<output>]
+ *
+ * Prints one line per record, or with --chrome a JSON file for chrome://tracing or Perfetto.
+ */
+int main(int argc, char* argv[])
+{
+    const bool chrome = argc > 1 && std::strcmp(argv[1], "--chrome") == 0;
+    const int  first  = chrome ? 2 : 1;
+    if (argc <= first || argc > first + 2) {
+        std::cerr << "usage: " << argv[0] << " [--chrome] <dump> [<output>]" << std::endl;
+        return 2;
+    }
+
+    std::ifstream in(argv[first], std::ios::binary);
+    if (!in) {
+        std::cerr << "cannot open '" << argv[first] << "'" << std::endl;
+        return 1;
+    }
+    std::ofstream file;
+    if (argc == first + 2) {
+        file.open(argv[first + 1], std::ios::trunc);
+        if (!file) {
+            std::cerr << "cannot create '" << argv[first + 1] << "'" << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = file.is_open() ? file : std::cout;
+
+    const bool decoded = chrome ? FlowTrace::decodeChromeTrace(in, out) : FlowTrace::decodeText(in, out);
+    if (!decoded) {
+        std::cerr << "'" << argv[first] << "' is not a valid flow trace dump" << std::endl;
+        return 1;
+    }
+    return 0;
+}